@@ -0,0 +1,279 @@
+#include "BBDLine.h"
+
+template <typename SampleType>
+BBDLine<SampleType>::InterpolatorTable::InterpolatorTable()
+{
+    // Blackman-windowed sinc, cut off just below Nyquist of the grid it is
+    // scaled to; read() normalises, so the table need not
+    const double cutoff = 0.9;
+    
+    for (int point = 0; point <= numTaps * numPhases; ++point)
+    {
+        const double x = static_cast<double>(point) / numPhases - halfWidth;
+        const double sinc = x == 0.0 ? 1.0 : std::sin(juce::MathConstants<double>::pi * cutoff * x)
+                                                 / (juce::MathConstants<double>::pi * cutoff * x);
+        const double window = 0.42 + 0.5 * std::cos(juce::MathConstants<double>::pi * x / halfWidth)
+                                   + 0.08 * std::cos(juce::MathConstants<double>::twoPi * x / halfWidth);
+        kernel[static_cast<size_t>(point)] = static_cast<float>(sinc * window);
+    }
+    
+    kernel.back() = 0.0f;
+}
+
+template <typename SampleType>
+const typename BBDLine<SampleType>::InterpolatorTable& BBDLine<SampleType>::getInterpolatorTable()
+{
+    static const InterpolatorTable table;
+    return table;
+}
+
+template <typename SampleType>
+BBDLine<SampleType>::BBDLine()
+    : currentSampleRate(44100.0)
+    , bucketIndex(0)
+    , minInputCutoffRatio(1.0)
+    , nextTickTime(0.0)
+    , samplesPerTick(0.0)
+    , clockScale(1.0)
+    , clockScaleStep(0.0)
+    , modulationPosition(controlInterval)
+{
+}
+
+template <typename SampleType>
+void BBDLine<SampleType>::prepare(double sampleRate, int maxBufferSize)
+{
+    juce::ignoreUnused(maxBufferSize);
+    currentSampleRate = sampleRate;
+    
+    // Build the shared table here rather than on the audio thread
+    getInterpolatorTable();
+    
+    buckets.resize(static_cast<size_t>(numStages), LaneOps::broadcast<SampleType>(0.0f));
+    
+    // The input kernel spans numTaps ticks, so the slowest tracked clock sets the
+    // input history's length; the output kernel spans at most numTaps host samples
+    const int inputHistorySize = juce::nextPowerOfTwo(static_cast<int>(std::ceil(numTaps * sampleRate / minTrackedTickRate)) + 2);
+    inputHistory.prepare(inputHistorySize);
+    outputHistory.prepare(numTaps * maxTicksPerSample);
+    minInputCutoffRatio = numTaps / (inputHistorySize - 2.0);
+    
+    lfo.prepare(sampleRate);
+    reset();
+}
+
+template <typename SampleType>
+void BBDLine<SampleType>::reset()
+{
+    std::fill(buckets.begin(), buckets.end(), LaneOps::broadcast<SampleType>(0.0f));
+    inputHistory.clear();
+    outputHistory.clear();
+    
+    bucketIndex = 0;
+    nextTickTime = 0.0;
+    samplesPerTick = 0.0;
+    
+    lfo.reset();
+    clockScale = 1.0;
+    clockScaleStep = 0.0;
+    modulationPosition = controlInterval;
+}
+
+template <typename SampleType>
+double BBDLine<SampleType>::getTickRate(float delayTimeMs) const
+{
+    // The interpolators add (halfWidth - 1) + halfWidth samples of whichever grid
+    // is slower; take them out of the brigade's share so the total matches the knob
+    const double interpolatorDelay = numTaps - 1;
+    const double seconds = delayTimeMs * 0.001;
+    
+    // Ticks slower than the host: the interpolator delay is in ticks...
+    double tickRate = (numStages + interpolatorDelay) / juce::jmax(1.0e-3, seconds);
+    
+    // ...otherwise in host samples (the two meet at tickRate == currentSampleRate)
+    if (tickRate > currentSampleRate)
+        tickRate = numStages / juce::jmax(1.0e-3, seconds - interpolatorDelay / currentSampleRate);
+    
+    // Never more ticks per host sample than processClocked can queue
+    return juce::jmin(tickRate, (maxTicksPerSample - 1) * currentSampleRate);
+}
+
+template <typename SampleType>
+void BBDLine<SampleType>::History::prepare(int newSize)
+{
+    jassert(juce::isPowerOfTwo(newSize));
+    size = newSize;
+    samples.resize(static_cast<size_t>(size * 2));
+    clear();
+}
+
+template <typename SampleType>
+void BBDLine<SampleType>::History::clear()
+{
+    std::fill(samples.begin(), samples.end(), LaneOps::broadcast<SampleType>(0.0f));
+    index = 0;
+}
+
+template <typename SampleType>
+void BBDLine<SampleType>::History::push(SampleType value)
+{
+    index = (index + 1) & (size - 1);
+    samples[static_cast<size_t>(index)] = value;
+    samples[static_cast<size_t>(index + size)] = value;
+}
+
+template <typename SampleType>
+SampleType BBDLine<SampleType>::History::read(double age, double cutoffRatio) const
+{
+    const auto& kernel = getInterpolatorTable().kernel;
+    
+    // Every stored sample within the kernel's reach, newest first
+    const double reach = halfWidth / cutoffRatio;
+    const int first = juce::jmax(0, static_cast<int>(std::ceil(age - reach)));
+    const int last = juce::jmin(size - 1, static_cast<int>(std::floor(age + reach)));
+    const SampleType* newest = samples.data() + index + size;
+    
+    // Kernel table position of each sample, stepping cutoffRatio samples of the kernel per stored sample
+    const float step = static_cast<float>(cutoffRatio * numPhases);
+    const float start = static_cast<float>((halfWidth - (age - first) * cutoffRatio) * numPhases);
+    
+    SampleType sum = LaneOps::broadcast<SampleType>(0.0f);
+    float weightSum = 0.0f;
+    
+    // Kernel at full width: every sample sits at the same phase, a whole kernel sample apart
+    if (cutoffRatio >= 1.0)
+    {
+        const int startPoint = juce::jlimit(0, numTaps * numPhases, static_cast<int>(start));
+        const float blend = start - static_cast<float>(startPoint);
+        
+        for (int sample = first, point = startPoint; sample <= last; ++sample, point = juce::jmin(numTaps * numPhases, point + numPhases))
+        {
+            const float weight = kernel[static_cast<size_t>(point)]
+                               + blend * (kernel[static_cast<size_t>(point + 1)] - kernel[static_cast<size_t>(point)]);
+            sum += newest[-sample] * weight;
+            weightSum += weight;
+        }
+        
+        return sum * (1.0f / weightSum);
+    }
+    
+    for (int sample = first; sample <= last; ++sample)
+    {
+        const float position = juce::jlimit(0.0f, static_cast<float>(numTaps * numPhases),
+                                            start + static_cast<float>(sample - first) * step);
+        const int point = static_cast<int>(position);
+        const float blend = position - static_cast<float>(point);
+        const float weight = kernel[static_cast<size_t>(point)]
+                           + blend * (kernel[static_cast<size_t>(point + 1)] - kernel[static_cast<size_t>(point)]);
+        sum += newest[-sample] * weight;
+        weightSum += weight;
+    }
+    
+    // Unity DC gain whatever the phase and width
+    return sum * (1.0f / weightSum);
+}
+
+template <typename SampleType>
+SampleType BBDLine<SampleType>::processClocked(SampleType inputSample, double hostSamplesPerTick, float feedbackGain)
+{
+    constexpr int bucketMask = numStages - 1;
+    
+    // 1. Clock out every tick that lands in (previous sample, this sample]; the
+    //    charge leaving the last bucket was loaded numStages ticks ago
+    double tickTimes[maxTicksPerSample];
+    int numTicks = 0;
+    
+    while (nextTickTime <= 1.0 && numTicks < maxTicksPerSample)
+    {
+        tickTimes[numTicks] = nextTickTime;
+        outputHistory.push(buckets[static_cast<size_t>((bucketIndex + numTicks) & bucketMask)]);
+        
+        ++numTicks;
+        nextTickTime += hostSamplesPerTick;
+    }
+    
+    // Each interpolator's cutoff follows the slower grid: ticks on the way in
+    // (anti-aliasing at long delays), host samples on the way out (at short ones)
+    const double inputCutoffRatio = juce::jlimit(minInputCutoffRatio, 1.0, 1.0 / hostSamplesPerTick);
+    const double outputCutoffRatio = juce::jmin(1.0, hostSamplesPerTick);
+    
+    // 2. Reconstruction: read the tick-rate output at this host instant, which
+    //    is ticksSinceLastTick after the newest tick and halfWidth slow-grid samples late
+    const double ticksSinceLastTick = 1.0 - (nextTickTime - 1.0) / hostSamplesPerTick;
+    SampleType delayedSample = outputHistory.read(halfWidth / outputCutoffRatio - ticksSinceLastTick, outputCutoffRatio);
+    
+    // 3. Feedback around the brigade with soft clipping, as in DelayLine
+    SampleType feedbackSample = SoftClip::tanh(delayedSample * feedbackGain);
+    inputHistory.push(SoftClip::tanh(inputSample + feedbackSample));
+    
+    // 4. Input sampling: load the buckets vacated in step 1 at their tick
+    //    instants, (halfWidth - 1) slow-grid samples late
+    const double inputDelay = (halfWidth - 1) / inputCutoffRatio;
+    for (int tick = 0; tick < numTicks; ++tick)
+        buckets[static_cast<size_t>((bucketIndex + tick) & bucketMask)] = inputHistory.read(1.0 - tickTimes[tick] + inputDelay, inputCutoffRatio);
+    
+    bucketIndex = (bucketIndex + numTicks) & bucketMask;
+    nextTickTime -= 1.0;
+    
+    return delayedSample;
+}
+
+template <typename SampleType>
+SampleType BBDLine<SampleType>::processSample(SampleType inputSample, float delayTimeMs, float feedback)
+{
+    if (buckets.empty())
+        return inputSample;
+    
+    // Clamp feedback to safe range (0-95% from design doc)
+    const float feedbackGain = juce::jlimit(0.0f, 0.95f, feedback / 100.0f);
+    
+    samplesPerTick = currentSampleRate / getTickRate(delayTimeMs);
+    return processClocked(inputSample, samplesPerTick, feedbackGain);
+}
+
+template <typename SampleType>
+void BBDLine<SampleType>::processBlock(const SampleType* input, SampleType* output, int numSamples,
+                                       float delayTimeMs, float feedback, float modulationHz)
+{
+    if (buckets.empty())
+    {
+        if (output != input)
+            std::copy(input, input + numSamples, output);
+        return;
+    }
+    
+    const float feedbackGain = juce::jlimit(0.0f, 0.95f, feedback);
+    const double targetSamplesPerTick = currentSampleRate / getTickRate(delayTimeMs);
+    
+    if (samplesPerTick <= 0.0)
+        samplesPerTick = targetSamplesPerTick;
+    
+    // Glide the clock period linearly across the block
+    const double step = numSamples > 0 ? (targetSamplesPerTick - samplesPerTick) / numSamples : 0.0;
+    
+    // Wobble depth as a fraction of the delay (the period scales the whole brigade)
+    const double depthRatio = ModulationLFO<float>::getDepthMs(modulationHz) / juce::jmax(1.0f, delayTimeMs);
+    const double minimumSamplesPerTick = 1.0 / (maxTicksPerSample - 1);
+    lfo.setRate(modulationHz);
+    
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if (modulationPosition == controlInterval)
+        {
+            const double nextScale = 1.0 + depthRatio * lfo.advance();
+            clockScaleStep = (nextScale - clockScale) / controlInterval;
+            modulationPosition = 0;
+        }
+        
+        ++modulationPosition;
+        clockScale += clockScaleStep;
+        samplesPerTick += step;
+        
+        output[i] = processClocked(input[i], juce::jmax(minimumSamplesPerTick, samplesPerTick * clockScale), feedbackGain);
+    }
+    
+    samplesPerTick = targetSamplesPerTick;
+}
+
+template class BBDLine<float>;
+template class BBDLine<LaneOps::FloatVector>;
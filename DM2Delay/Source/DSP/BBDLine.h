@@ -0,0 +1,144 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <vector>
+#include "LaneOps.h"
+#include "ModulationLFO.h"
+#include "SoftClip.h"
+
+/**
+ * BBDLine - Clock-domain MN3005 bucket brigade
+ * Alternative to DelayLine: exactly 4096 buckets advanced at the clock rate
+ * implied by the delay time (delay = stages / (2 x clock frequency)), so the
+ * bandwidth follows the clock just like the real chip.
+ *
+ * Each clock phase moves charge one stage, so the buckets tick at twice the
+ * clock frequency. Windowed-sinc interpolators move the signal from the host
+ * rate onto the tick grid (input sampling) and back (reconstruction). Each
+ * one's cutoff tracks the slower of the two rates, so it is the anti-aliasing
+ * filter when ticks are slower than the host (long delays) on the way in, and
+ * when they are faster (short delays) on the way out; the kernel widens in
+ * proportion so it keeps its stopband. Its weights depend only on the clock,
+ * which every lane shares.
+ *
+ * Modulation wobbles the clock itself, as on the pedal; every lane shares the
+ * clock, so the channels of a group wobble together.
+ *
+ * SampleType is float for one channel, or LaneOps::FloatVector to run the
+ * channels of one group through a single shared clock.
+ */
+template <typename SampleType>
+class BBDLine
+{
+public:
+    BBDLine();
+    ~BBDLine() = default;
+
+    /** Prepare for playback with given sample rate and max buffer size */
+    void prepare(double sampleRate, int maxBufferSize);
+
+    /** Reset the bucket brigade to silence */
+    void reset();
+
+    /**
+     * Process a single sample with feedback
+     * @param inputSample The input sample to delay
+     * @param delayTimeMs Delay time in milliseconds (sets the clock)
+     * @param feedback Feedback amount (0-95%)
+     * @return The delayed output sample
+     */
+    SampleType processSample(SampleType inputSample, float delayTimeMs, float feedback);
+
+    /**
+     * Process a block of samples with feedback (in-place safe)
+     * The clock glides from its previous rate to the new one across the block,
+     * so delay changes bend pitch like turning the knob on the pedal
+     * @param input Samples to delay
+     * @param output Destination for the delayed samples (may equal input)
+     * @param numSamples Number of samples to process
+     * @param delayTimeMs Delay time in milliseconds (sets the clock)
+     * @param feedback Feedback gain (0.0 to 0.95)
+     * @param modulationHz Clock wobble rate (0 = off)
+     */
+    void processBlock(const SampleType* input, SampleType* output, int numSamples,
+                      float delayTimeMs, float feedback, float modulationHz);
+
+    /** Bucket tick rate (twice the BBD clock frequency) for the given delay time */
+    double getTickRate(float delayTimeMs) const;
+
+    static constexpr int numStages = 4096;
+
+private:
+    // Interpolator: kernel width in samples of the slower grid, and table resolution per sample
+    static constexpr int numTaps = 16;
+    static constexpr int halfWidth = numTaps / 2;
+    static constexpr int numPhases = 64;
+
+    // Bucket ticks per host sample are bounded so a block needs no allocation
+    static constexpr int maxTicksPerSample = 32;
+
+    // Below this tick rate the input filter stops following the clock (bounds the input history)
+    static constexpr double minTrackedTickRate = 1000.0;
+
+    /** Windowed-sinc kernel from -halfWidth to +halfWidth, numPhases points per sample (plus one so lookups need no bounds check) */
+    struct InterpolatorTable
+    {
+        InterpolatorTable();
+        std::array<float, numTaps * numPhases + 2> kernel;
+    };
+
+    static const InterpolatorTable& getInterpolatorTable();
+
+    /** Ring of recent samples, stored twice (index and index + size) so every read is contiguous */
+    struct History
+    {
+        std::vector<SampleType> samples;
+        int size = 0;
+        int index = 0;
+
+        void prepare(int newSize);
+        void clear();
+        void push(SampleType value);
+
+        /**
+         * Band-limited read
+         * @param age Read position in samples before the newest one
+         * @param cutoffRatio Kernel cutoff relative to this ring's rate (0..1]; the kernel
+         *                    spans numTaps / cutoffRatio samples
+         */
+        SampleType read(double age, double cutoffRatio) const;
+    };
+
+    double currentSampleRate;
+
+    std::vector<SampleType> buckets;
+    int bucketIndex;
+
+    // Host-rate feedback-summed input and tick-rate bucket output
+    History inputHistory;
+    History outputHistory;
+
+    // Smallest input cutoff ratio the input history can hold the kernel for
+    double minInputCutoffRatio;
+
+    // Time of the next bucket tick, in host samples after the last processed one
+    double nextTickTime;
+
+    // Host samples between bucket ticks at the end of the last block (0 until the first block)
+    double samplesPerTick;
+
+    // Clock wobble: the period is scaled by clockScale, ramped linearly across
+    // each control step towards the LFO's next value
+    static constexpr int controlInterval = ModulationLFO<float>::controlInterval;
+
+    ModulationLFO<float> lfo;
+    double clockScale;
+    double clockScaleStep;
+    int modulationPosition;   // samples done in the current control step
+
+    /** Run one host sample through the brigade at the given tick rate */
+    SampleType processClocked(SampleType inputSample, double hostSamplesPerTick, float feedbackGain);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BBDLine)
+};
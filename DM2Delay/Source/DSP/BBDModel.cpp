@@ -1,84 +1,147 @@
 #include "BBDModel.h"
 
-BBDModel::BBDModel()
+template <typename SampleType>
+BBDModel<SampleType>::BBDModel()
     : currentSampleRate(44100.0)
-    , noiseFloor(0.0f)
-    , lastNoiseSample(0.0f)
+    , noiseDelayTimeMs(-1.0f)
+    , noiseAmplitude(0.0f)
 {
-    pinkFilterState[0] = 0.0f;
-    pinkFilterState[1] = 0.0f;
-    pinkFilterState[2] = 0.0f;
 }
 
-void BBDModel::prepare(double sampleRate)
+template <typename SampleType>
+void BBDModel<SampleType>::prepare(double sampleRate, int maxBufferSize)
 {
     currentSampleRate = sampleRate;
+    oversampler.prepare(maxBufferSize);
     reset();
 }
 
-void BBDModel::reset()
+template <typename SampleType>
+void BBDModel<SampleType>::reset()
 {
-    lastNoiseSample = 0.0f;
-    pinkFilterState[0] = 0.0f;
-    pinkFilterState[1] = 0.0f;
-    pinkFilterState[2] = 0.0f;
+    noise.reset();
+    oversampler.reset();
+    saturationClipper.reset();
 }
 
-float BBDModel::generateNoise(float delayTimeMs)
+template <typename SampleType>
+void BBDModel<SampleType>::setNoiseSeed(juce::uint32 seed)
 {
-    // Noise floor increases with longer delay times (BBD characteristic)
-    // Base noise at -60dB, increases slightly with delay time
-    float baseNoiseDB = -60.0f;
-    float delayFactor = delayTimeMs / 300.0f; // Normalize to max delay
-    float noiseDB = baseNoiseDB + (delayFactor * 6.0f); // Up to -54dB at max delay
-    
-    float noiseAmplitude = std::pow(10.0f, noiseDB / 20.0f);
-    
-    // Generate white noise
-    float white = random.nextFloat() * 2.0f - 1.0f;
-    
-    // Simple pink noise filter (Paul Kellet's approach)
-    pinkFilterState[0] = 0.99765f * pinkFilterState[0] + white * 0.0990460f;
-    pinkFilterState[1] = 0.96300f * pinkFilterState[1] + white * 0.2965164f;
-    pinkFilterState[2] = 0.57000f * pinkFilterState[2] + white * 1.0526913f;
-    
-    float pink = pinkFilterState[0] + pinkFilterState[1] + pinkFilterState[2] + white * 0.1848f;
-    pink *= 0.11f; // Normalize
-    
-    // Mix white and pink for BBD character (mostly pink)
-    float noise = (pink * 0.8f + white * 0.2f) * noiseAmplitude;
+    noise.setSeed(seed);
+}
+
+template <typename SampleType>
+void BBDModel<SampleType>::setOversamplingFactorLog2(int factorLog2)
+{
+    oversampler.setFactorLog2(factorLog2);
+}
+
+template <typename SampleType>
+float BBDModel<SampleType>::getLatencyInSamples() const
+{
+    if (oversampler.getFactor() == 1)
+        return SoftClip::TanhADAA<SampleType>::latencyInSamples;
     
-    // Smooth noise slightly to avoid harsh digital artifacts
-    noise = lastNoiseSample * 0.3f + noise * 0.7f;
-    lastNoiseSample = noise;
+    return static_cast<float>(oversampler.getLatencyInSamples());
+}
+
+template <typename SampleType>
+float BBDModel<SampleType>::getNoiseAmplitude(float delayTimeMs)
+{
+    // Delay time changes at control rate, so only redo the dB conversion when it moves
+    if (delayTimeMs != noiseDelayTimeMs)
+    {
+        // Noise floor increases with longer delay times (BBD characteristic)
+        // Base noise at -60dB, increases slightly with delay time
+        float baseNoiseDB = -60.0f;
+        float delayFactor = juce::jmin(delayTimeMs, 300.0f) / 300.0f; // Normalize to the pedal's max delay
+        float noiseDB = baseNoiseDB + (delayFactor * 6.0f); // Up to -54dB at 300 ms
+        
+        // Extended range: the ever slower clock keeps raising the floor, 3 dB per doubling
+        if (delayTimeMs > 300.0f)
+            noiseDB += 3.0f * std::log2(delayTimeMs / 300.0f);
+        
+        noiseAmplitude = std::pow(10.0f, noiseDB / 20.0f);
+        noiseDelayTimeMs = delayTimeMs;
+    }
     
-    return noise;
+    return noiseAmplitude;
 }
 
-float BBDModel::applySampleAndHold(float inputSample)
+template <typename SampleType>
+SampleType BBDModel<SampleType>::applySampleAndHold(SampleType inputSample)
 {
     // BBD sample-and-hold character is already handled by the delay line
     // and filtering stages, so we just add subtle quantization character
     
     // Very subtle bit-reduction effect (simulate BBD transfer non-linearity)
     const float steps = 4096.0f; // 12-bit equivalent
-    float quantized = std::round(inputSample * steps) / steps;
+    SampleType quantized = LaneOps::round(inputSample * steps) * (1.0f / steps);
     
     // Mix mostly original with subtle quantization
     return inputSample * 0.95f + quantized * 0.05f;
 }
 
-float BBDModel::processSample(float inputSample, float delayTimeMs)
+template <typename SampleType>
+void BBDModel<SampleType>::applySaturation(SampleType* block, int numSamples)
+{
+    // Not oversampled: ADAA of tanh(0.9x), then the 1.1 gain
+    if (oversampler.getFactor() == 1)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            block[i] *= 0.9f;
+        
+        saturationClipper.processBlock(block, numSamples);
+        
+        for (int i = 0; i < numSamples; ++i)
+            block[i] *= 1.1f;
+        
+        return;
+    }
+    
+    SampleType* upsampled = oversampler.processSamplesUp(block, numSamples);
+    const int numUpsampled = numSamples * oversampler.getFactor();
+    
+    SoftClip::scaledTanhBlock(upsampled, numUpsampled);
+    
+    oversampler.processSamplesDown(block, numSamples);
+}
+
+template <typename SampleType>
+SampleType BBDModel<SampleType>::processSample(SampleType inputSample, float delayTimeMs)
 {
     // Apply sample-and-hold character
-    float processed = applySampleAndHold(inputSample);
+    SampleType processed = applySampleAndHold(inputSample);
     
     // Add BBD noise
-    float noise = generateNoise(delayTimeMs);
-    processed += noise;
+    processed += noise.getNextSample(getNoiseAmplitude(delayTimeMs));
     
     // Subtle soft clipping (BBD saturation)
-    processed = std::tanh(processed * 0.9f) * 1.1f;
+    applySaturation(&processed, 1);
     
     return processed;
 }
+
+template <typename SampleType>
+void BBDModel<SampleType>::processBlock(const SampleType* input, SampleType* output, int numSamples, float delayTimeMs)
+{
+    // Sample-and-hold is stateless, so run it as its own pass over the block
+    for (int i = 0; i < numSamples; ++i)
+        output[i] = applySampleAndHold(input[i]);
+    
+    // Add BBD noise for the whole block at once
+    noise.addToBlock(output, numSamples, getNoiseAmplitude(delayTimeMs));
+    
+    // Subtle soft clipping (BBD saturation)
+    applySaturation(output, numSamples);
+}
+
+template <typename SampleType>
+void BBDModel<SampleType>::renderNoiseFloor(SampleType* output, int numSamples, float delayTimeMs)
+{
+    std::fill(output, output + numSamples, LaneOps::broadcast<SampleType>(0.0f));
+    noise.addToBlock(output, numSamples, getNoiseAmplitude(delayTimeMs));
+}
+
+template class BBDModel<float>;
+template class BBDModel<LaneOps::FloatVector>;
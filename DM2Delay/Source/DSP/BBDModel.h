@@ -1,48 +1,86 @@
 #pragma once
 
 #include <juce_core/juce_core.h>
+#include "LaneOps.h"
+#include "NoiseGenerator.h"
+#include "Oversampler.h"
+#include "SoftClip.h"
 
 /**
  * BBDModel - Bucket Brigade Device characteristics emulation
  * Adds BBD-specific artifacts: bandwidth limiting, noise, clock bleed
  * Based on design doc: MN3005 4096-stage BBD perceptual modeling
+ *
+ * SampleType is float for one channel, or LaneOps::FloatVector to keep one
+ * pink-noise filter per lane and draw independent noise for every channel.
  */
+template <typename SampleType>
 class BBDModel
 {
 public:
     BBDModel();
     ~BBDModel() = default;
 
-    /** Prepare for playback */
-    void prepare(double sampleRate);
+    /** Prepare for playback with given sample rate and max buffer size */
+    void prepare(double sampleRate, int maxBufferSize);
 
     /** Reset state */
     void reset();
 
+    /** Use a fixed noise seed so renders are reproducible (restarts the noise) */
+    void setNoiseSeed(juce::uint32 seed);
+
+    /** Run the saturation at 1x (0), 2x (1), 4x (2) or 8x (3) the host rate */
+    void setOversamplingFactorLog2(int factorLog2);
+
+    /** Latency added by the saturation, in samples (the oversampler's, or half a sample at 1x) */
+    float getLatencyInSamples() const;
+
     /**
      * Apply BBD character to a sample
      * @param inputSample The clean delayed sample
      * @param delayTimeMs Current delay time (affects noise floor)
      * @return Sample with BBD artifacts applied
      */
-    float processSample(float inputSample, float delayTimeMs);
+    SampleType processSample(SampleType inputSample, float delayTimeMs);
+
+    /**
+     * Apply BBD character to a block of samples (in-place safe)
+     * Noise is generated for the whole block at the block's noise amplitude
+     * @param input Clean delayed samples
+     * @param output Destination for the processed samples (may equal input)
+     * @param numSamples Number of samples to process
+     * @param delayTimeMs Current delay time (affects noise floor)
+     */
+    void processBlock(const SampleType* input, SampleType* output, int numSamples, float delayTimeMs);
+
+    /**
+     * Render just the noise floor (what processBlock adds to a silent delay line)
+     * Skips the saturation, which is linear at this level; used while the plugin idles
+     */
+    void renderNoiseFloor(SampleType* output, int numSamples, float delayTimeMs);
 
 private:
     double currentSampleRate;
-    juce::Random random;
-    
-    // BBD noise characteristics
-    float noiseFloor;
-    float lastNoiseSample;
+    NoiseGenerator<SampleType> noise;
+    Oversampler<SampleType> oversampler;
+
+    // Saturation at 1x: antiderivative anti-aliasing instead. The stage is outside the
+    // feedback loop, so the ADAA's slight smoothing is heard once, not on every repeat
+    SoftClip::TanhADAA<SampleType> saturationClipper;
     
-    // Simple pink noise filter (1/f approximation)
-    float pinkFilterState[3];
+    // Noise floor amplitude, recomputed only when the delay time changes
+    float noiseDelayTimeMs;
+    float noiseAmplitude;
     
-    /** Generate shaped BBD noise */
-    float generateNoise(float delayTimeMs);
+    /** Noise floor amplitude for the given delay time (cached) */
+    float getNoiseAmplitude(float delayTimeMs);
     
     /** Apply sample-and-hold character */
-    float applySampleAndHold(float inputSample);
+    static SampleType applySampleAndHold(SampleType inputSample);
+    
+    /** Subtle soft clipping (BBD saturation), oversampled or anti-aliased, in place */
+    void applySaturation(SampleType* block, int numSamples);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BBDModel)
 };
@@ -0,0 +1,190 @@
+#include "BBDStage.h"
+
+template <typename SampleType>
+BBDStage<SampleType>::BBDStage()
+    : currentSampleRate(44100.0)
+    , usingClockedEngine(false)
+    , silentSamples(0)
+    , wetPeak(0.0f)
+    , wetSumOfSquares(0.0f)
+    , profiling(false)
+    , sectionStart(0)
+{
+    sectionCycles.fill(0);
+}
+
+template <typename SampleType>
+void BBDStage<SampleType>::prepare(double sampleRate, int maxBlockSize, float maxDelayMs, bool compactDelayStorage)
+{
+    currentSampleRate = sampleRate;
+    
+    compander.prepare(sampleRate);
+    delayLine.setStorage(compactDelayStorage ? DelayLine<SampleType>::Storage::int16
+                                             : DelayLine<SampleType>::Storage::float32);
+    delayLine.prepare(sampleRate, maxBlockSize, maxDelayMs);
+    delayLine.setModulationPhaseSpread(juce::MathConstants<float>::halfPi); // neighbouring channels a quarter cycle apart
+    bbdLine.prepare(sampleRate, maxBlockSize);
+    bbdModel.prepare(sampleRate, maxBlockSize);
+    filter.prepare(sampleRate);
+    mixStage.prepare(sampleRate);
+    
+    reset();
+}
+
+template <typename SampleType>
+void BBDStage<SampleType>::reset()
+{
+    compander.reset();
+    delayLine.reset();
+    bbdLine.reset();
+    bbdModel.reset();
+    filter.reset();
+    mixStage.reset();
+    silentSamples = 0;
+    wetPeak = 0.0f;
+    wetSumOfSquares = 0.0f;
+}
+
+template <typename SampleType>
+void BBDStage<SampleType>::process(SampleType* frames, int numSamples, const Settings& settings,
+                                   SampleType* dry, SampleType* wet)
+{
+    beginSections();
+    
+    // Save the stage input for mixing
+    std::copy(frames, frames + numSamples, dry);
+    
+    // 1. Compressor (pre-BBD)
+    compander.compressBlock(dry, wet, numSamples);
+    endSection(Section::compress);
+    
+    // The BBD saturation adds latency to the wet path only; take it off the
+    // delay time so the echoes stay on the beat
+    const float saturationLatency = bbdModel.getLatencyInSamples();
+    const float saturationLatencyMs = 1000.0f * saturationLatency / static_cast<float>(currentSampleRate);
+    const float delayTime = settings.delayTime - saturationLatencyMs;
+    
+    // 2. BBD Delay (the engine that was idle holds stale echoes, so clear it on a switch)
+    if (settings.clockedEngine != usingClockedEngine)
+    {
+        delayLine.reset();
+        bbdLine.reset();
+        usingClockedEngine = settings.clockedEngine;
+    }
+    
+    if (settings.clockedEngine)
+        bbdLine.processBlock(wet, wet, numSamples, delayTime, settings.feedbackGain, settings.modulation);
+    else
+        delayLine.processBlock(wet, wet, numSamples, settings.delaySamples - saturationLatency,
+                               settings.feedbackGain, settings.modulation);
+    endSection(Section::delay);
+    
+    // 3. BBD artifacts
+    bbdModel.processBlock(wet, wet, numSamples, delayTime);
+    endSection(Section::bbd);
+    
+    // 4. Expander (post-BBD)
+    compander.expandBlock(wet, wet, numSamples);
+    endSection(Section::expand);
+    
+    // 5. Filter stage
+    filter.processBlock(wet, wet, numSamples, settings.tone);
+    endSection(Section::filter);
+    
+    // Wet level for the meters (a read-only pass over data that is already in cache)
+    wetPeak = LaneOps::getPeakLevel(wet, numSamples);
+    wetSumOfSquares = LaneOps::getSumOfSquares(wet, numSamples);
+    
+    // 6. Mix stage output
+    mixStage.processBlock(dry, wet, frames, numSamples, settings.mixLevel);
+    endSection(Section::mix);
+}
+
+template <typename SampleType>
+void BBDStage<SampleType>::processFadeOut(SampleType* frames, int numSamples, const Settings& settings,
+                                          SampleType* dry, SampleType* wet)
+{
+    process(frames, numSamples, settings, dry, wet);
+    
+    // dry still holds the stage input
+    const float fadeStep = 1.0f / static_cast<float>(juce::jmax(1, numSamples));
+    
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float gain = 1.0f - static_cast<float>(i + 1) * fadeStep;
+        frames[i] = dry[i] + (frames[i] - dry[i]) * gain;
+    }
+    
+    endSection(Section::mix);
+}
+
+template <typename SampleType>
+void BBDStage<SampleType>::processIdle(SampleType* frames, int numSamples, const Settings& settings,
+                                       SampleType* dry, SampleType* wet)
+{
+    beginSections();
+    std::copy(frames, frames + numSamples, dry);
+    
+    // Below the compander threshold and the saturation knee everything but the
+    // noise, tone filter and mix is unity, so skip it
+    bbdModel.renderNoiseFloor(wet, numSamples, settings.delayTime);
+    endSection(Section::bbd);
+    filter.processBlock(wet, wet, numSamples, settings.tone);
+    endSection(Section::filter);
+    mixStage.processBlock(dry, wet, frames, numSamples, settings.mixLevel);
+    endSection(Section::mix);
+}
+
+template <typename SampleType>
+bool BBDStage<SampleType>::updateSilence(const SampleType* frames, int numSamples, int tailSamples)
+{
+    // Any signal wakes the stage at once; the modules kept their (near-silent)
+    // state while idle, so the block renders in full without a jump
+    if (LaneOps::getPeakLevel(frames, numSamples) > silenceLevel)
+    {
+        silentSamples = 0;
+        return false;
+    }
+    
+    return updateSilence(numSamples, tailSamples);
+}
+
+template <typename SampleType>
+bool BBDStage<SampleType>::updateSilence(int numSamples, int tailSamples)
+{
+    silentSamples = juce::jmin(tailSamples, silentSamples + numSamples);
+    return silentSamples >= tailSamples;
+}
+
+template <typename SampleType>
+void BBDStage<SampleType>::collectSectionCycles(SectionCycles& total)
+{
+    for (size_t section = 0; section < sectionCycles.size(); ++section)
+        total[section] += sectionCycles[section];
+    
+    sectionCycles.fill(0);
+}
+
+template <typename SampleType>
+double BBDStage<SampleType>::getTailSeconds(const Settings& settings)
+{
+    // Repeat k arrives k delay times after the input stops, at feedback^(k - 1)
+    // of the ring's level, which the write clipper bounds at full scale
+    const float feedbackGain = juce::jlimit(0.0f, 0.95f, settings.feedbackGain);
+    double repeats = 1.0;
+    
+    if (feedbackGain > 0.0f)
+        repeats += std::ceil(std::log(tailDecayLevel) / std::log(feedbackGain));
+    
+    // Modulation can hold each repeat back by up to its depth
+    const double repeatSeconds = (settings.delayTime + ModulationLFO<float>::getDepthMs(settings.modulation)) * 0.001;
+    
+    // After a delay change the old (longer) delay is still read while the time
+    // glides; five time constants cover the glide from any delay to any other
+    const double glideSeconds = 5.0 * DelayLine<SampleType>::delaySmoothingMs * 0.001;
+    
+    return repeats * repeatSeconds + glideSeconds;
+}
+
+template class BBDStage<float>;
+template class BBDStage<LaneOps::FloatVector>;
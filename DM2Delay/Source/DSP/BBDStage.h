@@ -0,0 +1,180 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include "LaneOps.h"
+#include "CycleCounter.h"
+#include "Compander.h"
+#include "DelayLine.h"
+#include "BBDLine.h"
+#include "BBDModel.h"
+#include "Filter.h"
+#include "MixStage.h"
+
+/**
+ * BBDStage - One complete DM-2 delay stage
+ * Compander, delay engine (ring buffer or clocked brigade), BBD artifacts,
+ * tone filter and dry/wet mix, rendered a block at a time, each module over
+ * the whole block before the next.
+ *
+ * Stages carry no routing of their own: StageGraph chains them in series or
+ * runs them side by side, and hands them its scratch space.
+ *
+ * SampleType is float for one channel, or LaneOps::FloatVector to run the
+ * channels of one group side by side.
+ */
+template <typename SampleType>
+class BBDStage
+{
+public:
+    /**
+     * Control values for one block, already in the units the modules use
+     * (the processor derives them once per block from its parameter snapshot)
+     */
+    struct Settings
+    {
+        bool enabled = true;
+        bool clockedEngine = false;
+        float delayTime = 100.0f;   // ms (clock rate, BBD artifacts, tail)
+        float delaySamples = 0.0f;  // delayTime at the host rate (ring buffer engine)
+        float feedbackGain = 0.0f;  // 0-0.95
+        float modulation = 0.0f;    // Hz
+        float tone = 100.0f;        // %
+        float mixLevel = 0.0f;      // 0-1
+    };
+
+    /** Sections of a rendered block, timed while profiling */
+    enum class Section
+    {
+        compress,
+        delay,
+        bbd,
+        expand,
+        filter,
+        mix
+    };
+
+    static constexpr int numSections = 6;
+    using SectionCycles = std::array<CycleCounter::Count, numSections>;
+
+    BBDStage();
+    ~BBDStage() = default;
+
+    /**
+     * Prepare for playback
+     * @param maxDelayMs Longest delay time the ring buffer engine must hold
+     * @param compactDelayStorage Store the ring as 16-bit fixed point rather than float
+     */
+    void prepare(double sampleRate, int maxBlockSize, float maxDelayMs, bool compactDelayStorage);
+
+    /** Clear every module's state */
+    void reset();
+
+    /** Fix the noise seed for reproducible renders */
+    void setNoiseSeed(juce::uint32 seed) { bbdModel.setNoiseSeed(seed); }
+
+    /** Oversampling factor of the BBD saturation (no allocation, resets its filters) */
+    void setOversamplingFactorLog2(int factorLog2) { bbdModel.setOversamplingFactorLog2(factorLog2); }
+
+    /**
+     * Render a block in place
+     * @param dry, wet Scratch space for numSamples samples each
+     */
+    void process(SampleType* frames, int numSamples, const Settings& settings, SampleType* dry, SampleType* wet);
+
+    /**
+     * Render a block in place while fading from the stage's output to its input,
+     * so the stage can stop running without a step (arguments as for process)
+     */
+    void processFadeOut(SampleType* frames, int numSamples, const Settings& settings, SampleType* dry, SampleType* wet);
+
+    /**
+     * Idle version of process: the delay path is silent, so only its noise
+     * floor is rendered (arguments as for process)
+     */
+    void processIdle(SampleType* frames, int numSamples, const Settings& settings, SampleType* dry, SampleType* wet);
+
+    /** Wet signal of the last process call (before the mix): peak, and sum of squares over lanes and samples */
+    float getWetPeak() const { return wetPeak; }
+    float getWetSumOfSquares() const { return wetSumOfSquares; }
+
+    /** Compressor gain at the end of the last block, lowest across lanes (1 = no reduction) */
+    float getCompressionGain() const { return compander.getCompressionGain(); }
+
+    /** Time each section of every rendered block (off by default, when it costs a branch per section) */
+    void setProfiling(bool shouldProfile) { profiling = shouldProfile; }
+
+    /** Add the cycles spent in each section since the last collect to total, and restart the count */
+    void collectSectionCycles(SectionCycles& total);
+
+    /**
+     * Count silent input
+     * @return true once the input has stayed below silenceLevel for tailSamples,
+     *         i.e. the stage's own repeats have died away
+     */
+    bool updateSilence(const SampleType* frames, int numSamples, int tailSamples);
+
+    /**
+     * Count a block of silent input without looking at it: it is an idle
+     * upstream stage's noise floor, which sits above silenceLevel
+     * @return as for updateSilence
+     */
+    bool updateSilence(int numSamples, int tailSamples);
+
+    /** Time until the repeats have died away once the input stops (allowing for modulation and delay glides) */
+    static double getTailSeconds(const Settings& settings);
+
+    // Input peaks below this count as silence (-80 dBFS)
+    static constexpr float silenceLevel = 1.0e-4f;
+
+    // Time for the compander release, filters and oversamplers to settle after the last repeat
+    static constexpr double tailSettleSeconds = 0.25;
+
+private:
+    // Repeats count as gone once 60 dB down, below the BBD noise floor
+    static constexpr float tailDecayLevel = 1.0e-3f;
+
+    Compander<SampleType> compander;
+    DelayLine<SampleType> delayLine;
+    BBDLine<SampleType> bbdLine; // clocked engine, alternative to delayLine
+    BBDModel<SampleType> bbdModel;
+    Filter<SampleType> filter;
+    MixStage<SampleType> mixStage;
+
+    double currentSampleRate;
+
+    // Engine that rendered the last block, so a switch starts from silence
+    bool usingClockedEngine;
+
+    // Samples since the input last rose above silenceLevel (saturates at the tail length)
+    int silentSamples;
+
+    // Wet level of the last process call, for metering
+    float wetPeak;
+    float wetSumOfSquares;
+
+    // Profiling: cycles per section since the last collect, and when the current section began
+    bool profiling;
+    SectionCycles sectionCycles;
+    CycleCounter::Count sectionStart;
+
+    /** Start timing a block's first section */
+    void beginSections()
+    {
+        if (profiling)
+            sectionStart = CycleCounter::now();
+    }
+
+    /** Charge the time since the previous section ended to this one */
+    void endSection(Section section)
+    {
+        if (profiling)
+        {
+            const auto now = CycleCounter::now();
+            sectionCycles[static_cast<size_t>(section)] += now - sectionStart;
+            sectionStart = now;
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BBDStage)
+};
@@ -1,53 +1,92 @@
 #include "Compander.h"
 #include <cmath>
 
-Compander::Compander()
+namespace
+{
+    // Threshold at -20dB (0.1 linear)
+    constexpr float threshold = 0.1f;
+    
+    // Offset that keeps log10 finite in the reference gain computer
+    constexpr float envelopeFloor = 1e-6f;
+    
+    // Gain limits
+    constexpr float minimumGain = 0.1f;
+    constexpr float maximumGain = 3.0f;
+}
+
+template <typename SampleType>
+Compander<SampleType>::Compander()
     : currentSampleRate(44100.0)
-    , compressEnvelope(0.0f)
-    , expandEnvelope(0.0f)
-    , attackCoeff(0.0f)
-    , releaseCoeff(0.0f)
+    , compressEnvelope(LaneOps::broadcast<SampleType>(0.0f))
+    , expandEnvelope(LaneOps::broadcast<SampleType>(0.0f))
+    , attackCoeff(LaneOps::broadcast<SampleType>(0.0f))
+    , releaseCoeff(LaneOps::broadcast<SampleType>(0.0f))
+    , thresholdLevel(LaneOps::broadcast<SampleType>(threshold))
+    , inverseThreshold(LaneOps::broadcast<SampleType>(1.0f / threshold))
+    , envelopeOffset(LaneOps::broadcast<SampleType>(envelopeFloor))
+    , minGain(LaneOps::broadcast<SampleType>(minimumGain))
+    , maxGain(LaneOps::broadcast<SampleType>(maximumGain))
+    , unityGain(LaneOps::broadcast<SampleType>(1.0f))
 {
 }
 
-void Compander::prepare(double sampleRate)
+template <typename SampleType>
+void Compander<SampleType>::prepare(double sampleRate)
 {
     currentSampleRate = sampleRate;
     
     // Attack time: 1ms (fast response)
     float attackTimeMs = 1.0f;
-    attackCoeff = 1.0f - std::exp(-1.0f / (attackTimeMs * 0.001f * static_cast<float>(sampleRate)));
+    attackCoeff = LaneOps::broadcast<SampleType>(
+        1.0f - std::exp(-1.0f / (attackTimeMs * 0.001f * static_cast<float>(sampleRate))));
     
     // Release time: 50ms (medium recovery)
     float releaseTimeMs = 50.0f;
-    releaseCoeff = 1.0f - std::exp(-1.0f / (releaseTimeMs * 0.001f * static_cast<float>(sampleRate)));
+    releaseCoeff = LaneOps::broadcast<SampleType>(
+        1.0f - std::exp(-1.0f / (releaseTimeMs * 0.001f * static_cast<float>(sampleRate))));
     
     reset();
 }
 
-void Compander::reset()
+template <typename SampleType>
+void Compander<SampleType>::reset()
 {
-    compressEnvelope = 0.0f;
-    expandEnvelope = 0.0f;
+    compressEnvelope = LaneOps::broadcast<SampleType>(0.0f);
+    expandEnvelope = LaneOps::broadcast<SampleType>(0.0f);
 }
 
-float Compander::updateEnvelope(float inputLevel, float currentEnvelope)
+template <typename SampleType>
+SampleType Compander<SampleType>::updateEnvelope(SampleType inputLevel, SampleType currentEnvelope)
 {
     // Absolute value for envelope detection
-    float absLevel = std::abs(inputLevel);
+    SampleType absLevel = LaneOps::abs(inputLevel);
     
     // Attack if input > envelope, release if input < envelope
-    float coeff = (absLevel > currentEnvelope) ? attackCoeff : releaseCoeff;
+    SampleType coeff = LaneOps::selectGreater(absLevel, currentEnvelope, attackCoeff, releaseCoeff);
     
     // Smooth envelope follower
     return currentEnvelope + coeff * (absLevel - currentEnvelope);
 }
 
-float Compander::computeGain(float envelope, bool isCompression)
+template <typename SampleType>
+SampleType Compander<SampleType>::computeGain(SampleType envelope, bool isCompression) const
 {
-    // Threshold at -20dB (0.1 linear)
-    const float threshold = 0.1f;
+    // In dB the 2:1 law is gainDB = k * (envDB - thresholdDB), with k = -1/2 when
+    // compressing and k = 1 when expanding. Back in linear terms that is
+    // (env / threshold)^k, so the threshold term becomes one multiply and the
+    // gain is a reciprocal square root (compress) or the ratio itself (expand)
+    SampleType relativeLevel = (envelope + envelopeOffset) * inverseThreshold;
     
+    SampleType gain = isCompression ? LaneOps::reciprocalSqrt(relativeLevel) : relativeLevel;
+    gain = LaneOps::clamp(gain, minGain, maxGain);
+    
+    // Below threshold, no change
+    return LaneOps::selectGreater(thresholdLevel, envelope, unityGain, gain);
+}
+
+template <typename SampleType>
+float Compander<SampleType>::computeReferenceGain(float envelope, bool isCompression)
+{
     // 2:1 compression ratio
     const float ratio = 2.0f;
     
@@ -55,7 +94,7 @@ float Compander::computeGain(float envelope, bool isCompression)
         return 1.0f; // Below threshold, no change
     
     // Calculate gain reduction/expansion
-    float envDB = 20.0f * std::log10(envelope + 1e-6f);
+    float envDB = 20.0f * std::log10(envelope + envelopeFloor);
     float thresholdDB = 20.0f * std::log10(threshold);
     
     float gainChangeDB;
@@ -75,29 +114,87 @@ float Compander::computeGain(float envelope, bool isCompression)
     float gain = std::pow(10.0f, gainChangeDB / 20.0f);
     
     // Smooth limiting
-    return juce::jlimit(0.1f, 3.0f, gain);
+    return juce::jlimit(minimumGain, maximumGain, gain);
 }
 
-float Compander::compress(float inputSample)
+template <typename SampleType>
+float Compander<SampleType>::getGainComputerError() const
+{
+    float maxError = 0.0f;
+    
+    // Sweep past both gain limits (expand saturates at 0.3, compress at 10.0)
+    for (int step = 0; step <= 24000; ++step)
+    {
+        const float envelope = static_cast<float>(step) * 0.0005f;
+        
+        for (bool isCompression : { true, false })
+        {
+            const float reference = computeReferenceGain(envelope, isCompression);
+            const float gain = LaneOps::getLane(computeGain(LaneOps::broadcast<SampleType>(envelope), isCompression), 0);
+            
+            maxError = juce::jmax(maxError, std::abs(gain - reference) / reference);
+        }
+    }
+    
+    return maxError;
+}
+
+template <typename SampleType>
+SampleType Compander<SampleType>::compress(SampleType inputSample)
 {
     // Update envelope
     compressEnvelope = updateEnvelope(inputSample, compressEnvelope);
     
     // Calculate compression gain
-    float gain = computeGain(compressEnvelope, true);
+    SampleType gain = computeGain(compressEnvelope, true);
     
     // Apply gain
     return inputSample * gain;
 }
 
-float Compander::expand(float inputSample)
+template <typename SampleType>
+SampleType Compander<SampleType>::expand(SampleType inputSample)
 {
     // Update envelope
     expandEnvelope = updateEnvelope(inputSample, expandEnvelope);
     
     // Calculate expansion gain
-    float gain = computeGain(expandEnvelope, false);
+    SampleType gain = computeGain(expandEnvelope, false);
     
     // Apply gain
     return inputSample * gain;
 }
+
+template <typename SampleType>
+void Compander<SampleType>::compressBlock(const SampleType* input, SampleType* output, int numSamples)
+{
+    // Keep the envelope in a local so the loop doesn't round-trip through memory
+    SampleType envelope = compressEnvelope;
+    
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const SampleType inputSample = input[i];
+        envelope = updateEnvelope(inputSample, envelope);
+        output[i] = inputSample * computeGain(envelope, true);
+    }
+    
+    compressEnvelope = envelope;
+}
+
+template <typename SampleType>
+void Compander<SampleType>::expandBlock(const SampleType* input, SampleType* output, int numSamples)
+{
+    SampleType envelope = expandEnvelope;
+    
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const SampleType inputSample = input[i];
+        envelope = updateEnvelope(inputSample, envelope);
+        output[i] = inputSample * computeGain(envelope, false);
+    }
+    
+    expandEnvelope = envelope;
+}
+
+template class Compander<float>;
+template class Compander<LaneOps::FloatVector>;
@@ -1,13 +1,18 @@
 #pragma once
 
 #include <juce_core/juce_core.h>
+#include "LaneOps.h"
 
 /**
  * Compander - Compression/Expansion for BBD noise reduction
  * Implements 2:1 compression before delay, 2:1 expansion after
  * Based on design doc: NE570/SA571 dual compander emulation
  * Achieves ~10-15dB noise reduction
+ *
+ * SampleType is float for one channel, or LaneOps::FloatVector to run
+ * one envelope per lane (one channel per lane) in a single pass.
  */
+template <typename SampleType>
 class Compander
 {
 public:
@@ -25,31 +30,74 @@ public:
      * @param inputSample Input signal
      * @return Compressed signal (boosted quiet, reduced loud)
      */
-    float compress(float inputSample);
+    SampleType compress(SampleType inputSample);
 
     /**
      * Apply expansion (post-BBD)
      * @param inputSample Compressed signal from BBD
      * @return Expanded signal (restored dynamics, reduced noise)
      */
-    float expand(float inputSample);
+    SampleType expand(SampleType inputSample);
+
+    /**
+     * Apply compression to a block of samples (in-place safe)
+     * @param input Input signal
+     * @param output Destination for the compressed signal (may equal input)
+     * @param numSamples Number of samples to process
+     */
+    void compressBlock(const SampleType* input, SampleType* output, int numSamples);
+
+    /**
+     * Apply expansion to a block of samples (in-place safe)
+     * @param input Compressed signal from BBD
+     * @param output Destination for the expanded signal (may equal input)
+     * @param numSamples Number of samples to process
+     */
+    void expandBlock(const SampleType* input, SampleType* output, int numSamples);
+
+    /** Compressor gain at the end of the last block, lowest across lanes (1 = no reduction) */
+    float getCompressionGain() const { return LaneOps::getMinimum(computeGain(compressEnvelope, true)); }
+
+    /** The gain computer must stay within this relative error of the dB-domain reference */
+    static constexpr float maxGainError = 1e-6f;
+
+    /**
+     * Largest relative error of the gain computer against the dB-domain
+     * reference, swept over the whole envelope range
+     * Slow (log10 and pow per point): for the null-test tool, not for prepare()
+     */
+    float getGainComputerError() const;
 
 private:
     double currentSampleRate;
     
     // Envelope followers for compression/expansion
-    float compressEnvelope;
-    float expandEnvelope;
+    SampleType compressEnvelope;
+    SampleType expandEnvelope;
     
     // Attack/release coefficients (from design doc: 1ms attack, 50ms release)
-    float attackCoeff;
-    float releaseCoeff;
+    SampleType attackCoeff;
+    SampleType releaseCoeff;
+    
+    // Gain computer constants, broadcast once in prepare()
+    SampleType thresholdLevel;
+    SampleType inverseThreshold;
+    SampleType envelopeOffset;
+    SampleType minGain;
+    SampleType maxGain;
+    SampleType unityGain;
     
     /** Update envelope follower */
-    float updateEnvelope(float inputLevel, float currentEnvelope);
+    SampleType updateEnvelope(SampleType inputLevel, SampleType currentEnvelope);
     
-    /** Apply gain computation (2:1 ratio) */
-    float computeGain(float envelope, bool isCompression);
+    /**
+     * Apply gain computation (2:1 ratio) to every lane
+     * Closed form of the dB-domain law, so no log10/pow per sample
+     */
+    SampleType computeGain(SampleType envelope, bool isCompression) const;
+
+    /** Original dB-domain gain computer, kept as the accuracy reference */
+    static float computeReferenceGain(float envelope, bool isCompression);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Compander)
 };
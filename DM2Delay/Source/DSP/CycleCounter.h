@@ -0,0 +1,31 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+/**
+ * CycleCounter - The cheapest timestamp available, for timing sections of a block
+ * The time-stamp counter on x86 (a few cycles to read, and constant-rate on
+ * any recent CPU), the high-resolution tick counter elsewhere. Counts are only
+ * compared with each other; wall time is measured separately.
+ */
+namespace CycleCounter
+{
+    using Count = juce::uint64;
+
+    inline Count now() noexcept
+    {
+       #if JUCE_INTEL
+        return static_cast<Count>(__rdtsc());
+       #else
+        return static_cast<Count>(juce::Time::getHighResolutionTicks());
+       #endif
+    }
+}
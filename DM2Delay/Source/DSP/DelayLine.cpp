@@ -1,108 +1,419 @@
 #include "DelayLine.h"
 
-DelayLine::DelayLine()
-    : writeIndex(0)
+template <typename SampleType>
+DelayLine<SampleType>::DelayLine()
+    : storage(Storage::float32)
+    , bufferMask(0)
+    , writeIndex(0)
     , currentSampleRate(44100.0)
     , maxDelaySamples(0)
+    , delaySmoothingCoeff(1.0)
+    , smoothedDelay(-1.0)
+    , smoothedDepth(0.0)
+    , intervalPosition(controlInterval)
+    , intervalMinDelay(0)
+    , delayMoving(false)
 {
+    intervalStartDelay.fill(0.0);
+    delayStep.fill(0.0);
 }
 
-void DelayLine::prepare(double sampleRate, int maxBufferSize)
+template <typename SampleType>
+void DelayLine<SampleType>::prepare(double sampleRate, int maxBufferSize, float maxDelayMs)
 {
     juce::ignoreUnused(maxBufferSize);
     currentSampleRate = sampleRate;
     
-    // Maximum delay time is 300ms (from design doc)
-    maxDelaySamples = static_cast<int>(std::ceil(sampleRate * 0.3)) + 4; // +4 for interpolation safety
+    maxDelaySamples = static_cast<int>(std::ceil(sampleRate * maxDelayMs * 0.001)) + 4; // +4 for interpolation safety
+    
+    // Power-of-two capacity so the ring wraps with a mask; only the chosen format is allocated
+    const int capacity = juce::nextPowerOfTwo(maxDelaySamples);
+    
+    if (storage == Storage::int16)
+    {
+        compactBuffer.resize(static_cast<size_t>(capacity) * numLanes);
+        std::vector<SampleType>().swap(buffer);
+    }
+    else
+    {
+        buffer.resize(static_cast<size_t>(capacity));
+        std::vector<juce::int16>().swap(compactBuffer);
+    }
+    
+    bufferMask = capacity - 1;
+    
+    lfo.prepare(sampleRate);
+    delaySmoothingCoeff = 1.0 - std::exp(-controlInterval / (delaySmoothingMs * 0.001 * sampleRate));
     
-    buffer.resize(maxDelaySamples, 0.0f);
     reset();
 }
 
-void DelayLine::reset()
+template <typename SampleType>
+void DelayLine<SampleType>::reset()
 {
-    std::fill(buffer.begin(), buffer.end(), 0.0f);
+    std::fill(buffer.begin(), buffer.end(), LaneOps::broadcast<SampleType>(0.0f));
+    std::fill(compactBuffer.begin(), compactBuffer.end(), static_cast<juce::int16>(0));
     writeIndex = 0;
+    
+    lfo.reset();
+    smoothedDelay = -1.0;
+    smoothedDepth = 0.0;
+    delayStep.fill(0.0);
+    intervalPosition = controlInterval;
+    delayMoving = false;
 }
 
-float DelayLine::getDelayInSamples(float delayTimeMs) const
+template <typename SampleType>
+float DelayLine<SampleType>::getDelayInSamples(float delayTimeMs) const
 {
     return (delayTimeMs / 1000.0f) * static_cast<float>(currentSampleRate);
 }
 
-float DelayLine::processSample(float inputSample, float delayTimeMs, float feedback)
+template <typename SampleType>
+float DelayLine<SampleType>::getClampedDelaySamples(float delaySamples) const
+{
+    return juce::jlimit(1.0f, static_cast<float>(maxDelaySamples - 4), delaySamples);
+}
+
+template <typename SampleType>
+SampleType DelayLine<SampleType>::processSample(SampleType inputSample, float delayTimeMs, float feedback)
 {
-    if (buffer.empty())
+    if (! isPrepared())
         return inputSample;
     
     // Clamp feedback to safe range (0-95% from design doc)
-    feedback = juce::jlimit(0.0f, 0.95f, feedback / 100.0f);
+    float feedbackGain = juce::jlimit(0.0f, 0.95f, feedback / 100.0f);
+    
+    return processClamped(inputSample, getClampedDelaySamples(getDelayInSamples(delayTimeMs)), feedbackGain);
+}
+
+template <typename SampleType>
+void DelayLine<SampleType>::processBlock(const SampleType* input, SampleType* output, int numSamples,
+                                         float delayInSamples, float feedback, float modulationHz)
+{
+    if (! isPrepared())
+    {
+        if (output != input)
+            std::copy(input, input + numSamples, output);
+        return;
+    }
+    
+    // Parameters are constant across the block, so clamp them once
+    const float feedbackGain = juce::jlimit(0.0f, 0.95f, feedback);
+    const float delaySamples = getClampedDelaySamples(delayInSamples);
+    const double depthSamples = ModulationLFO<SampleType>::getDepthMs(modulationHz) * 0.001 * currentSampleRate;
+    
+    lfo.setRate(modulationHz);
+    
+    // The first block after a reset starts at its delay rather than gliding there
+    if (smoothedDelay < 0.0)
+    {
+        smoothedDelay = delaySamples;
+        intervalStartDelay.fill(delaySamples);
+        delayStep.fill(0.0);
+    }
+    
+    SampleType delayed[chunkSize];
+    
+    // Moving delay: ramp every lane across each control step
+    if (delayMoving || smoothedDelay != static_cast<double>(delaySamples) || depthSamples > 0.0)
+    {
+        for (int start = 0; start < numSamples;)
+        {
+            if (intervalPosition == controlInterval)
+                beginControlInterval(delaySamples, depthSamples);
+            
+            // A segment's reads (up to 2 samples past each read position) must
+            // all land on samples written before the segment starts
+            const int count = juce::jmax(1, juce::jmin(numSamples - start, controlInterval - intervalPosition,
+                                                       juce::jmin(chunkSize, intervalMinDelay - 2)));
+            
+            readMovingSegment(delayed, count);
+            writeWithFeedback(delayed, input + start, count, feedbackGain);
+            std::copy(delayed, delayed + count, output + start);
+            
+            intervalPosition += count;
+            start += count;
+        }
+        
+        return;
+    }
+    
+    // Settled: the next movement starts a fresh control step
+    intervalPosition = controlInterval;
+    
+    // Read position = write position - delay: a whole-sample offset behind the
+    // write pointer plus a fixed fraction, both unchanged for the whole block
+    const int readOffset = static_cast<int>(std::ceil(delaySamples));
+    const float fraction = static_cast<float>(readOffset) - delaySamples;
+    
+    // A segment's reads (up to 2 samples past the read position) must all
+    // land on samples written before the segment starts
+    const int maxSegment = juce::jmin(chunkSize, readOffset - 2);
+    
+    if (maxSegment < 1)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            output[i] = processClamped(input[i], delaySamples, feedbackGain);
+        return;
+    }
+    
+    for (int start = 0; start < numSamples; start += maxSegment)
+    {
+        const int count = juce::jmin(maxSegment, numSamples - start);
+        
+        readSegment((writeIndex - readOffset) & bufferMask, fraction, delayed, count);
+        writeWithFeedback(delayed, input + start, count, feedbackGain);
+        
+        // Input is consumed, so output may now overwrite it
+        std::copy(delayed, delayed + count, output + start);
+    }
+}
+
+template <typename SampleType>
+void DelayLine<SampleType>::writeWithFeedback(const SampleType* delayed, const SampleType* input,
+                                              int numSamples, float feedbackGain)
+{
+    SampleType written[chunkSize];
+    
+    // Soft clip feedback to prevent runaway, then write input + feedback
+    // with soft clipping
+    for (int i = 0; i < numSamples; ++i)
+        written[i] = delayed[i] * feedbackGain;
+    
+    SoftClip::tanhBlock(written, numSamples);
+    
+    for (int i = 0; i < numSamples; ++i)
+        written[i] += input[i];
     
-    // Get delay in samples
-    float delaySamples = getDelayInSamples(delayTimeMs);
-    delaySamples = juce::jlimit(1.0f, static_cast<float>(maxDelaySamples - 4), delaySamples);
+    SoftClip::tanhBlock(written, numSamples);
+    writeSegment(written, numSamples);
+}
+
+template <typename SampleType>
+void DelayLine<SampleType>::beginControlInterval(double targetDelay, double targetDepth)
+{
+    // One-pole glides, snapped once they are inaudibly close
+    smoothedDelay += (targetDelay - smoothedDelay) * delaySmoothingCoeff;
+    if (std::abs(targetDelay - smoothedDelay) < 1.0e-3)
+        smoothedDelay = targetDelay;
+    
+    smoothedDepth += (targetDepth - smoothedDepth) * delaySmoothingCoeff;
+    if (std::abs(targetDepth - smoothedDepth) < 1.0e-3)
+        smoothedDepth = targetDepth;
+    
+    const SampleType wobble = smoothedDepth > 0.0 ? lfo.advance() : LaneOps::broadcast<SampleType>(0.0f);
+    const double minimumDelay = 1.0;
+    const double maximumDelay = static_cast<double>(maxDelaySamples - 4);
+    
+    double shortest = maximumDelay;
+    bool moving = smoothedDelay != targetDelay || smoothedDepth > 0.0;
+    
+    for (size_t lane = 0; lane < numLanes; ++lane)
+    {
+        // The new step starts where the last one ended
+        const double startDelay = intervalStartDelay[lane] + delayStep[lane] * controlInterval;
+        const double endDelay = juce::jlimit(minimumDelay, maximumDelay,
+                                             smoothedDelay + smoothedDepth * LaneOps::getLane(wobble, lane));
+        
+        intervalStartDelay[lane] = startDelay;
+        delayStep[lane] = (endDelay - startDelay) / controlInterval;
+        shortest = juce::jmin(shortest, startDelay, endDelay);
+        moving = moving || endDelay != startDelay;
+    }
+    
+    intervalMinDelay = static_cast<int>(shortest);
+    intervalPosition = 0;
+    delayMoving = moving;
+}
+
+template <typename SampleType>
+void DelayLine<SampleType>::readMovingSegment(SampleType* destination, int numSamples) const
+{
+    auto* values = reinterpret_cast<float*>(destination);
+    
+    if (storage == Storage::int16)
+        readMovingTaps(compactBuffer.data(), 1.0f / int16Scale, values, numSamples);
+    else
+        readMovingTaps(reinterpret_cast<const float*>(buffer.data()), 1.0f, values, numSamples);
+}
+
+template <typename SampleType>
+template <typename TapType>
+void DelayLine<SampleType>::readMovingTaps(const TapType* ring, float tapScale, float* values, int numSamples) const
+{
+    constexpr int stride = static_cast<int>(numLanes);
     
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const double stepsDone = static_cast<double>(intervalPosition + i + 1);
+        
+        for (int lane = 0; lane < stride; ++lane)
+        {
+            // Read position relative to the segment's first write, split into a
+            // whole-sample index and a fraction (in double: delays reach 2^19 samples)
+            const double delay = intervalStartDelay[static_cast<size_t>(lane)] + delayStep[static_cast<size_t>(lane)] * stepsDone;
+            const double readPosition = static_cast<double>(i) - delay;
+            const double whole = std::floor(readPosition);
+            const float f = static_cast<float>(readPosition - whole);
+            const int index = writeIndex + static_cast<int>(whole);
+            
+            // 4-point cubic (Hermite) interpolation, as in readSegment
+            const float f2 = f * f;
+            const float f3 = f2 * f;
+            const float w0 = -0.5f * f + f2 - 0.5f * f3;
+            const float w1 = 1.0f - 2.5f * f2 + 1.5f * f3;
+            const float w2 = 0.5f * f + 2.0f * f2 - 1.5f * f3;
+            const float w3 = -0.5f * f2 + 0.5f * f3;
+            
+            const float y0 = static_cast<float>(ring[((index - 1) & bufferMask) * stride + lane]);
+            const float y1 = static_cast<float>(ring[(index & bufferMask) * stride + lane]);
+            const float y2 = static_cast<float>(ring[((index + 1) & bufferMask) * stride + lane]);
+            const float y3 = static_cast<float>(ring[((index + 2) & bufferMask) * stride + lane]);
+            
+            values[i * stride + lane] = (y0 * w0 + y1 * w1 + y2 * w2 + y3 * w3) * tapScale;
+        }
+    }
+}
+
+template <typename SampleType>
+SampleType DelayLine<SampleType>::processClamped(SampleType inputSample, float delaySamples, float feedbackGain)
+{
     // Read delayed sample with interpolation
-    float delayedSample = readInterpolated(delaySamples);
+    SampleType delayedSample = readInterpolated(delaySamples);
     
     // Soft clip feedback to prevent runaway
-    float feedbackSample = std::tanh(delayedSample * feedback);
+    SampleType feedbackSample = SoftClip::tanh(delayedSample * feedbackGain);
     
     // Write input + feedback to buffer with soft clipping
-    float bufferInput = std::tanh(inputSample + feedbackSample);
+    SampleType bufferInput = SoftClip::tanh(inputSample + feedbackSample);
     
-    jassert(writeIndex >= 0 && writeIndex < static_cast<int>(buffer.size()));
-    buffer[writeIndex] = bufferInput;
-    
-    // Advance write index (circular buffer)
-    writeIndex = (writeIndex + 1) % static_cast<int>(buffer.size());
+    writeSegment(&bufferInput, 1);
     
     return delayedSample;
 }
 
-float DelayLine::readInterpolated(float delaySamples)
+template <typename SampleType>
+SampleType DelayLine<SampleType>::readInterpolated(float delaySamples) const
 {
-    if (buffer.empty())
-        return 0.0f;
-    
-    int bufferSize = static_cast<int>(buffer.size());
+    if (! isPrepared())
+        return LaneOps::broadcast<SampleType>(0.0f);
     
-    // Calculate read position
-    float readPos = static_cast<float>(writeIndex) - delaySamples;
+    const int readOffset = static_cast<int>(std::ceil(delaySamples));
+    const float fraction = static_cast<float>(readOffset) - delaySamples;
     
-    // Wrap negative positions
-    while (readPos < 0.0f)
-        readPos += static_cast<float>(bufferSize);
+    SampleType delayedSample;
+    readSegment((writeIndex - readOffset) & bufferMask, fraction, &delayedSample, 1);
+    return delayedSample;
+}
+
+template <typename SampleType>
+void DelayLine<SampleType>::readSegment(int firstIndex, float fraction, SampleType* destination, int numSamples) const
+{
+    // 4-point cubic (Hermite) interpolation, as tap weights for the fixed fraction
+    const float f = fraction;
+    const float f2 = f * f;
+    const float f3 = f2 * f;
+    const float w0 = -0.5f * f + f2 - 0.5f * f3;
+    const float w1 = 1.0f - 2.5f * f2 + 1.5f * f3;
+    const float w2 = 0.5f * f + 2.0f * f2 - 1.5f * f3;
+    const float w3 = -0.5f * f2 + 0.5f * f3;
     
-    // Ensure readPos is within valid range
-    while (readPos >= static_cast<float>(bufferSize))
-        readPos -= static_cast<float>(bufferSize);
+    const int capacity = bufferMask + 1;
+    const bool contiguous = firstIndex >= 1 && firstIndex + numSamples + 1 < capacity;
     
-    // Get integer and fractional parts
-    int index0 = static_cast<int>(std::floor(readPos)) % bufferSize;
-    float frac = readPos - std::floor(readPos);
+    if (storage == Storage::int16)
+    {
+        // Lane values are stored flat, so tap k of value v is numLanes * k further on;
+        // the fixed-point scale folds into the weights
+        const float s0 = w0 / int16Scale, s1 = w1 / int16Scale, s2 = w2 / int16Scale, s3 = w3 / int16Scale;
+        const juce::int16* ring = compactBuffer.data();
+        auto* values = reinterpret_cast<float*>(destination);
+        constexpr int stride = static_cast<int>(numLanes);
+        
+        if (contiguous)
+        {
+            const juce::int16* taps = ring + (firstIndex - 1) * stride;
+            const int numValues = numSamples * stride;
+            
+            for (int v = 0; v < numValues; ++v)
+                values[v] = taps[v] * s0 + taps[v + stride] * s1 + taps[v + 2 * stride] * s2 + taps[v + 3 * stride] * s3;
+            
+            return;
+        }
+        
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const int index = firstIndex + i;
+            const juce::int16* y0 = ring + ((index - 1) & bufferMask) * stride;
+            const juce::int16* y1 = ring + (index & bufferMask) * stride;
+            const juce::int16* y2 = ring + ((index + 1) & bufferMask) * stride;
+            const juce::int16* y3 = ring + ((index + 2) & bufferMask) * stride;
+            
+            for (int lane = 0; lane < stride; ++lane)
+                values[i * stride + lane] = y0[lane] * s0 + y1[lane] * s1 + y2[lane] * s2 + y3[lane] * s3;
+        }
+        
+        return;
+    }
     
-    // Get 4 samples for cubic interpolation with safe wrapping
-    int index1 = (index0 + 1) % bufferSize;
-    int index2 = (index0 + 2) % bufferSize;
-    int indexMinus1 = (index0 - 1 + bufferSize) % bufferSize;
+    const SampleType* ring = buffer.data();
     
-    // Bounds checking for safety
-    jassert(indexMinus1 >= 0 && indexMinus1 < bufferSize);
-    jassert(index0 >= 0 && index0 < bufferSize);
-    jassert(index1 >= 0 && index1 < bufferSize);
-    jassert(index2 >= 0 && index2 < bufferSize);
+    // Fast path: the taps of every output lie between ring[0] and ring[capacity - 1]
+    if (contiguous)
+    {
+        const SampleType* taps = ring + firstIndex - 1;
+        
+        for (int i = 0; i < numSamples; ++i)
+            destination[i] = taps[i] * w0 + taps[i + 1] * w1 + taps[i + 2] * w2 + taps[i + 3] * w3;
+        
+        return;
+    }
     
-    float y0 = buffer[indexMinus1];
-    float y1 = buffer[index0];
-    float y2 = buffer[index1];
-    float y3 = buffer[index2];
+    // The window straddles the wrap point: mask every tap
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const int index = firstIndex + i;
+        destination[i] = ring[(index - 1) & bufferMask] * w0
+                       + ring[index & bufferMask] * w1
+                       + ring[(index + 1) & bufferMask] * w2
+                       + ring[(index + 2) & bufferMask] * w3;
+    }
+}
+
+template <typename SampleType>
+void DelayLine<SampleType>::writeSegment(const SampleType* source, int numSamples)
+{
+    // At most two contiguous runs: up to the end of the ring, then from its start
+    const int firstRun = juce::jmin(numSamples, bufferMask + 1 - writeIndex);
     
-    // 4-point cubic interpolation (Hermite)
-    float c0 = y1;
-    float c1 = 0.5f * (y2 - y0);
-    float c2 = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
-    float c3 = 0.5f * (y3 - y0) + 1.5f * (y1 - y2);
+    if (storage == Storage::int16)
+    {
+        const auto* values = reinterpret_cast<const float*>(source);
+        constexpr int stride = static_cast<int>(numLanes);
+        
+        // Round half away from zero by truncating, which vectorises unlike lround
+        auto quantise = [](float value)
+        {
+            const float scaled = juce::jlimit(-1.0f, 1.0f, value) * int16Scale;
+            return static_cast<juce::int16>(scaled + (scaled < 0.0f ? -0.5f : 0.5f));
+        };
+        
+        juce::int16* firstDestination = compactBuffer.data() + writeIndex * stride;
+        for (int v = 0; v < firstRun * stride; ++v)
+            firstDestination[v] = quantise(values[v]);
+        
+        for (int v = firstRun * stride; v < numSamples * stride; ++v)
+            compactBuffer[static_cast<size_t>(v - firstRun * stride)] = quantise(values[v]);
+    }
+    else
+    {
+        std::copy(source, source + firstRun, buffer.begin() + writeIndex);
+        std::copy(source + firstRun, source + numSamples, buffer.begin());
+    }
     
-    return ((c3 * frac + c2) * frac + c1) * frac + c0;
+    writeIndex = (writeIndex + numSamples) & bufferMask;
 }
+
+template class DelayLine<float>;
+template class DelayLine<LaneOps::FloatVector>;
@@ -1,21 +1,62 @@
 #pragma once
 
 #include <juce_core/juce_core.h>
+#include <array>
 #include <vector>
+#include "LaneOps.h"
+#include "ModulationLFO.h"
+#include "SoftClip.h"
 
 /**
  * DelayLine - Fractional delay line with feedback
  * Implements circular buffer with cubic interpolation for smooth delay times
- * Based on design doc: 4096-stage delay with variable delay time (20-300ms)
+ * Based on design doc: 4096-stage delay with variable delay time (20-300ms,
+ * extendable; the maximum is set in prepare())
+ *
+ * The ring has a power-of-two capacity so every wrap is a mask. Within a
+ * block the delay is constant, so the read pointer advances one sample per
+ * sample with a fixed fraction: blocks are split into segments shorter than
+ * the delay (their reads never see their own writes), and each segment reads
+ * its cubic taps straight from contiguous memory unless it crosses the wrap.
+ *
+ * Delay time changes glide (one-pole, about 20 ms) instead of jumping, and the
+ * modulation LFO swings the delay of each lane around that. While either is
+ * moving, the delay is ramped linearly across each LFO control step and every
+ * lane is read at its own position; once settled, blocks return to the
+ * constant-delay path above.
+ *
+ * The ring can hold 16-bit fixed point instead of floats: everything written
+ * has been through the tanh clipper, so +/-1 full scale loses nothing but the
+ * bottom of a 96 dB range the MN3005 never had, and halves memory traffic.
+ *
+ * SampleType is float for one channel, or LaneOps::FloatVector to keep the
+ * channels interleaved in one buffer that shares a single read position.
  */
+template <typename SampleType>
 class DelayLine
 {
 public:
     DelayLine();
     ~DelayLine() = default;
 
-    /** Prepare for playback with given sample rate and max buffer size */
-    void prepare(double sampleRate, int maxBufferSize);
+    /** Time constant of the delay time glide (and of the modulation depth's) */
+    static constexpr double delaySmoothingMs = 20.0;
+
+    /** Ring buffer sample format */
+    enum class Storage
+    {
+        float32,
+        int16
+    };
+
+    /** Choose the ring buffer format; takes effect at the next prepare() */
+    void setStorage(Storage newStorage) { storage = newStorage; }
+
+    /**
+     * Prepare for playback with given sample rate and max buffer size
+     * @param maxDelayMs Longest delay time the ring must hold
+     */
+    void prepare(double sampleRate, int maxBufferSize, float maxDelayMs);
 
     /** Reset the delay line to silence */
     void reset();
@@ -27,19 +68,95 @@ public:
      * @param feedback Feedback amount (0.0 to 0.95)
      * @return The delayed output sample
      */
-    float processSample(float inputSample, float delayTimeMs, float feedback);
+    SampleType processSample(SampleType inputSample, float delayTimeMs, float feedback);
+
+    /**
+     * Process a block of samples with feedback (in-place safe)
+     * Delay and feedback come precomputed from the block's parameter snapshot
+     * and are clamped once for the whole block; the delay glides towards the
+     * new time and wobbles at the modulation rate
+     * @param input Samples to delay
+     * @param output Destination for the delayed samples (may equal input)
+     * @param numSamples Number of samples to process
+     * @param delayInSamples Delay time in samples at the prepared rate
+     * @param feedback Feedback gain (0.0 to 0.95)
+     * @param modulationHz Clock wobble rate (0 = off)
+     */
+    void processBlock(const SampleType* input, SampleType* output, int numSamples,
+                      float delayInSamples, float feedback, float modulationHz);
+
+    /** Phase offset between neighbouring lanes' wobble, in radians (stereo width) */
+    void setModulationPhaseSpread(float radians) { lfo.setLanePhaseSpread(radians); }
 
     /** Get the current delay time in samples */
     float getDelayInSamples(float delayTimeMs) const;
 
 private:
-    std::vector<float> buffer;
+    static constexpr size_t numLanes = LaneOps::numLanes<SampleType>();
+
+    // Samples per block segment (stack scratch for the reads and the feedback path)
+    static constexpr int chunkSize = 64;
+
+    // 16-bit full scale (the write path never exceeds +/-1)
+    static constexpr float int16Scale = 32767.0f;
+
+    Storage storage;
+    std::vector<SampleType> buffer;          // Storage::float32
+    std::vector<juce::int16> compactBuffer;  // Storage::int16, numLanes values per sample
+    int bufferMask;
     int writeIndex;
     double currentSampleRate;
     int maxDelaySamples;
 
+    static constexpr int controlInterval = ModulationLFO<SampleType>::controlInterval;
+
+    ModulationLFO<SampleType> lfo;
+    double delaySmoothingCoeff;
+    double smoothedDelay;   // base delay in samples (negative: jump to the next block's)
+    double smoothedDepth;   // modulation swing in samples
+
+    // Per-lane delay ramp of the current control step: delay after k of its samples
+    // is intervalStartDelay + k * delayStep
+    std::array<double, numLanes> intervalStartDelay;
+    std::array<double, numLanes> delayStep;
+    int intervalPosition;   // samples done in the current step (controlInterval: next one is due)
+    int intervalMinDelay;   // shortest whole delay anywhere in the current step
+    bool delayMoving;       // false once every lane holds smoothedDelay with no wobble
+
+    /** True once prepare() has allocated the ring */
+    bool isPrepared() const { return bufferMask > 0; }
+
     /** Read from buffer with cubic interpolation */
-    float readInterpolated(float delaySamples);
+    SampleType readInterpolated(float delaySamples) const;
+
+    /**
+     * Read numSamples consecutive cubic-interpolated samples
+     * @param firstIndex Ring index of the sample just before the first read position
+     * @param fraction Position between firstIndex and the next sample (same for every output)
+     */
+    void readSegment(int firstIndex, float fraction, SampleType* destination, int numSamples) const;
+
+    /** Append numSamples samples at the write pointer */
+    void writeSegment(const SampleType* source, int numSamples);
+
+    /** Write input plus soft-clipped feedback of the delayed samples */
+    void writeWithFeedback(const SampleType* delayed, const SampleType* input, int numSamples, float feedbackGain);
+
+    /** Step the glide and the LFO, and ramp each lane to its new delay over the next control step */
+    void beginControlInterval(double targetDelay, double targetDepth);
+
+    /** Read numSamples cubic-interpolated samples, each lane at its own moving position */
+    void readMovingSegment(SampleType* destination, int numSamples) const;
+
+    /** readMovingSegment for one storage format (taps scaled by tapScale) */
+    template <typename TapType>
+    void readMovingTaps(const TapType* ring, float tapScale, float* values, int numSamples) const;
+
+    /** Clamp a delay in samples to the valid range */
+    float getClampedDelaySamples(float delaySamples) const;
+
+    /** Read, apply feedback and write one sample using pre-clamped parameters */
+    SampleType processClamped(SampleType inputSample, float delaySamples, float feedbackGain);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DelayLine)
 };
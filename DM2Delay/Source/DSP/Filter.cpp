@@ -1,49 +1,107 @@
 #include "Filter.h"
+#include <cmath>
 
-Filter::Filter()
+template <typename SampleType>
+void Filter<SampleType>::StateVariableLowpass::setPrewarpedGain(float g)
+{
+    // k = 1 / Q for Q = 0.707
+    constexpr float k = 1.41421356f;
+    
+    a1 = 1.0f / (1.0f + g * (g + k));
+    a2 = g * a1;
+    a3 = g * a2;
+}
+
+template <typename SampleType>
+void Filter<SampleType>::StateVariableLowpass::reset()
+{
+    ic1eq = LaneOps::broadcast<SampleType>(0.0f);
+    ic2eq = LaneOps::broadcast<SampleType>(0.0f);
+}
+
+template <typename SampleType>
+SampleType Filter<SampleType>::StateVariableLowpass::processSample(SampleType input)
+{
+    const SampleType v3 = input - ic2eq;
+    const SampleType v1 = ic1eq * a1 + v3 * a2;
+    const SampleType v2 = ic2eq + ic1eq * a2 + v3 * a3;
+    
+    ic1eq = v1 * 2.0f - ic1eq;
+    ic2eq = v2 * 2.0f - ic2eq;
+    
+    return v2;
+}
+
+template <typename SampleType>
+Filter<SampleType>::Filter()
     : currentSampleRate(44100.0)
-    , lastTonePercent(-1.0f)
+    , smoothedTone(-1.0f)
+    , toneSmoothingCoeff(1.0f)
 {
+    toneGainTable.fill(0.0f);
 }
 
-void Filter::prepare(double sampleRate)
+template <typename SampleType>
+void Filter<SampleType>::prepare(double sampleRate)
 {
     currentSampleRate = sampleRate;
     
     // Fixed BBD lowpass at 5 kHz (removes clock artifacts)
-    auto bbdCoefficients = juce::dsp::IIR::Coefficients<float>::makeLowPass(
-        sampleRate, 5000.0, 0.707); // Q = 0.707 (Butterworth)
+    bhdLowpass.setPrewarpedGain(getPrewarpedGain(5000.0));
     
-    *bhdLowpass.coefficients = *bbdCoefficients;
+    // Map 0-100% to 3-8 kHz cutoff frequency, one table entry per percent
+    for (int step = 0; step <= numToneSteps; ++step)
+        toneGainTable[static_cast<size_t>(step)] = getPrewarpedGain(3000.0 + 5000.0 * step / numToneSteps);
+    
+    // Smoothing coefficient for tone changes (10ms smoothing time)
+    const float smoothingTimeMs = 10.0f;
+    toneSmoothingCoeff = 1.0f - std::exp(-1.0f / (smoothingTimeMs * 0.001f * static_cast<float>(sampleRate)));
     
     reset();
 }
 
-void Filter::reset()
+template <typename SampleType>
+void Filter<SampleType>::reset()
 {
     bhdLowpass.reset();
     toneControl.reset();
-    lastTonePercent = -1.0f;
+    smoothedTone = -1.0f;
 }
 
-void Filter::updateToneFilter(float tonePercent)
+template <typename SampleType>
+float Filter<SampleType>::getPrewarpedGain(double cutoffHz) const
 {
-    // Only update if tone changed significantly (avoid zipper noise)
-    if (std::abs(tonePercent - lastTonePercent) < 0.1f)
-        return;
+    const double limitedCutoff = juce::jmin(cutoffHz, currentSampleRate * 0.45);
+    return static_cast<float>(std::tan(juce::MathConstants<double>::pi * limitedCutoff / currentSampleRate));
+}
+
+template <typename SampleType>
+void Filter<SampleType>::updateToneFilter(float tonePercent)
+{
+    const float previousTone = smoothedTone;
     
-    lastTonePercent = tonePercent;
+    // Jump straight to the first value after a reset, glide afterwards and
+    // snap once close enough that the remaining step is inaudible
+    if (smoothedTone < 0.0f || std::abs(tonePercent - smoothedTone) < 0.01f)
+        smoothedTone = tonePercent;
+    else
+        smoothedTone += toneSmoothingCoeff * (tonePercent - smoothedTone);
     
-    // Map 0-100% to 3-8 kHz cutoff frequency
-    float cutoffHz = 3000.0f + (tonePercent / 100.0f) * 5000.0f;
+    if (smoothedTone == previousTone)
+        return;
     
-    auto toneCoefficients = juce::dsp::IIR::Coefficients<float>::makeLowPass(
-        currentSampleRate, cutoffHz, 0.707);
+    // Interpolate the prewarped gain between table entries
+    const float position = smoothedTone * (numToneSteps / 100.0f);
+    const int index = juce::jmin(static_cast<int>(position), numToneSteps - 1);
+    const float fraction = position - static_cast<float>(index);
+    const float g0 = toneGainTable[static_cast<size_t>(index)];
+    const float g1 = toneGainTable[static_cast<size_t>(index + 1)];
     
-    *toneControl.coefficients = *toneCoefficients;
+    toneControl.setPrewarpedGain(g0 + fraction * (g1 - g0));
 }
 
-float Filter::processSample(float inputSample, float tonePercent)
+template <typename SampleType>
+SampleType Filter<SampleType>::processSample(SampleType inputSample, float tonePercent)
 {
     // Clamp tone to valid range
     tonePercent = juce::jlimit(0.0f, 100.0f, tonePercent);
@@ -52,8 +110,28 @@ float Filter::processSample(float inputSample, float tonePercent)
     updateToneFilter(tonePercent);
     
     // Process through both filters
-    float filtered = bhdLowpass.processSample(inputSample);
+    SampleType filtered = bhdLowpass.processSample(inputSample);
     filtered = toneControl.processSample(filtered);
     
     return filtered;
 }
+
+template <typename SampleType>
+void Filter<SampleType>::processBlock(const SampleType* input, SampleType* output, int numSamples, float tonePercent)
+{
+    // Tone is constant across the block, so clamp it once
+    const float targetTone = juce::jlimit(0.0f, 100.0f, tonePercent);
+    
+    for (int i = 0; i < numSamples; ++i)
+        output[i] = bhdLowpass.processSample(input[i]);
+    
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // Coefficients only change while the tone is still gliding
+        updateToneFilter(targetTone);
+        output[i] = toneControl.processSample(output[i]);
+    }
+}
+
+template class Filter<float>;
+template class Filter<LaneOps::FloatVector>;
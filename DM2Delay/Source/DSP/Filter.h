@@ -1,13 +1,22 @@
 #pragma once
 
 #include <juce_core/juce_core.h>
-#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include "LaneOps.h"
 
 /**
  * Filter - Lowpass filter for BBD clock noise removal and tone control
  * Implements biquad lowpass (3-5 kHz) plus variable tone control (3-8 kHz)
  * Based on design doc filter stage requirements
+ *
+ * Both filters are topology-preserving state variable lowpasses with plain
+ * member coefficients. Tone cutoffs come from a table built in prepare() and
+ * glide with the smoothed tone value, so automation never allocates or steps.
+ *
+ * SampleType is float for one channel, or LaneOps::FloatVector to run the
+ * filter state of every lane side by side with shared coefficients.
  */
+template <typename SampleType>
 class Filter
 {
 public:
@@ -26,18 +35,55 @@ public:
      * @param tonePercent Tone control (0-100%, maps to 3-8 kHz cutoff)
      * @return Filtered output sample
      */
-    float processSample(float inputSample, float tonePercent);
+    SampleType processSample(SampleType inputSample, float tonePercent);
+
+    /**
+     * Process a block of samples through the filter chain (in-place safe)
+     * @param input Input samples
+     * @param output Destination for the filtered samples (may equal input)
+     * @param numSamples Number of samples to process
+     * @param tonePercent Tone control (0-100%, maps to 3-8 kHz cutoff)
+     */
+    void processBlock(const SampleType* input, SampleType* output, int numSamples, float tonePercent);
 
 private:
+    /** Trapezoidal-integrated (TPT) SVF lowpass, Q fixed at 0.707 (Butterworth) */
+    struct StateVariableLowpass
+    {
+        float a1 = 1.0f;
+        float a2 = 0.0f;
+        float a3 = 0.0f;
+        SampleType ic1eq = LaneOps::broadcast<SampleType>(0.0f);
+        SampleType ic2eq = LaneOps::broadcast<SampleType>(0.0f);
+
+        /** Set the cutoff from the prewarped gain g = tan(pi * cutoff / sampleRate) */
+        void setPrewarpedGain(float g);
+
+        void reset();
+
+        SampleType processSample(SampleType input);
+    };
+
+    // Tone table resolution: one entry per percent, linearly interpolated
+    static constexpr int numToneSteps = 100;
+
     double currentSampleRate;
     
     // Two-stage filtering: BBD anti-aliasing + tone control
-    juce::dsp::IIR::Filter<float> bhdLowpass;      // Fixed 5kHz BBD filter
-    juce::dsp::IIR::Filter<float> toneControl;     // Variable tone filter
+    StateVariableLowpass bhdLowpass;      // Fixed 5kHz BBD filter
+    StateVariableLowpass toneControl;     // Variable tone filter
+    
+    // Prewarped gain for each tone step (0-100%)
+    std::array<float, numToneSteps + 1> toneGainTable;
+    
+    // Tone glides towards the parameter value (-1 = jump on next update)
+    float smoothedTone;
+    float toneSmoothingCoeff;
     
-    float lastTonePercent;
+    /** Prewarped gain for a cutoff in Hz (kept below Nyquist) */
+    float getPrewarpedGain(double cutoffHz) const;
     
-    /** Update tone control filter coefficients */
+    /** Advance tone smoothing by one sample and update the tone filter if it moved */
     void updateToneFilter(float tonePercent);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Filter)
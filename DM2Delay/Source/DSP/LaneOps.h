@@ -0,0 +1,150 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <cmath>
+#include <type_traits>
+
+/**
+ * LaneOps - Helpers that let the DSP modules run on either a single channel
+ * (float) or several channels side by side in one SIMD register.
+ *
+ * Each lane of a FloatVector carries one channel, so serial recurrences
+ * (envelopes, IIR state, delay feedback) advance every channel in one pass.
+ * Operations with no SIMD form (log, random) fall back to per-lane calls;
+ * saturation kernels live in SoftClip.h.
+ */
+namespace LaneOps
+{
+    using FloatVector = juce::dsp::SIMDRegister<float>;
+
+    /** Number of channels carried by one sample of the given type */
+    template <typename SampleType>
+    constexpr size_t numLanes()
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+            return 1;
+        else
+            return SampleType::size();
+    }
+
+    /** Same value in every lane */
+    template <typename SampleType>
+    inline SampleType broadcast(float value)
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+            return value;
+        else
+            return SampleType::expand(value);
+    }
+
+    /** Read one lane */
+    inline float getLane(float sample, size_t) { return sample; }
+    inline float getLane(FloatVector sample, size_t lane) { return sample.get(lane); }
+
+    /** Write one lane */
+    inline void setLane(float& sample, size_t, float value) { sample = value; }
+    inline void setLane(FloatVector& sample, size_t lane, float value) { sample.set(lane, value); }
+
+    /** Apply a scalar function to every lane */
+    template <typename Function>
+    inline float map(float sample, Function&& function) { return function(sample); }
+
+    template <typename Function>
+    inline FloatVector map(FloatVector sample, Function&& function)
+    {
+        auto result = FloatVector::expand(0.0f);
+        for (size_t lane = 0; lane < FloatVector::size(); ++lane)
+            result.set(lane, function(sample.get(lane)));
+        return result;
+    }
+
+    /** Fill every lane from a scalar generator (one call per lane, in lane order) */
+    template <typename SampleType, typename Generator>
+    inline SampleType generate(Generator&& generator)
+    {
+        auto result = broadcast<SampleType>(0.0f);
+        for (size_t lane = 0; lane < numLanes<SampleType>(); ++lane)
+            setLane(result, lane, generator());
+        return result;
+    }
+
+    inline float abs(float sample) { return std::abs(sample); }
+    inline FloatVector abs(FloatVector sample) { return FloatVector::max(sample, FloatVector::expand(0.0f) - sample); }
+
+    /** Largest absolute value over a block, across all lanes */
+    template <typename SampleType>
+    inline float getPeakLevel(const SampleType* samples, int numSamples)
+    {
+        auto peak = broadcast<SampleType>(0.0f);
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if constexpr (std::is_same_v<SampleType, float>)
+                peak = juce::jmax(peak, std::abs(samples[i]));
+            else
+                peak = SampleType::max(peak, abs(samples[i]));
+        }
+
+        float level = 0.0f;
+        for (size_t lane = 0; lane < numLanes<SampleType>(); ++lane)
+            level = juce::jmax(level, getLane(peak, lane));
+
+        return level;
+    }
+
+    /** Sum of squares over a block, across all lanes */
+    template <typename SampleType>
+    inline float getSumOfSquares(const SampleType* samples, int numSamples)
+    {
+        auto sum = broadcast<SampleType>(0.0f);
+        for (int i = 0; i < numSamples; ++i)
+            sum += samples[i] * samples[i];
+
+        float total = 0.0f;
+        for (size_t lane = 0; lane < numLanes<SampleType>(); ++lane)
+            total += getLane(sum, lane);
+
+        return total;
+    }
+
+    /** Smallest value across the lanes of one sample */
+    inline float getMinimum(float sample) { return sample; }
+    inline float getMinimum(FloatVector sample)
+    {
+        float minimum = sample.get(0);
+        for (size_t lane = 1; lane < FloatVector::size(); ++lane)
+            minimum = juce::jmin(minimum, sample.get(lane));
+        return minimum;
+    }
+
+    /** Per lane: ifGreater where a > b, otherwise ifNotGreater */
+    inline float selectGreater(float a, float b, float ifGreater, float ifNotGreater)
+    {
+        return (a > b) ? ifGreater : ifNotGreater;
+    }
+
+    inline FloatVector selectGreater(FloatVector a, FloatVector b,
+                                     FloatVector ifGreater, FloatVector ifNotGreater)
+    {
+        auto mask = FloatVector::greaterThan(a, b);
+        return (ifGreater & mask) + (ifNotGreater & ~mask);
+    }
+
+    /** Per lane: value limited to [lower, upper] */
+    inline float clamp(float sample, float lower, float upper) { return juce::jlimit(lower, upper, sample); }
+    inline FloatVector clamp(FloatVector sample, FloatVector lower, FloatVector upper)
+    {
+        return FloatVector::min(FloatVector::max(sample, lower), upper);
+    }
+
+    template <typename SampleType>
+    inline SampleType reciprocalSqrt(SampleType sample)
+    {
+        return map(sample, [](float x) { return 1.0f / std::sqrt(x); });
+    }
+
+    template <typename SampleType>
+    inline SampleType round(SampleType sample)
+    {
+        return map(sample, [](float x) { return std::round(x); });
+    }
+}
@@ -1,7 +1,8 @@
 #include "MixStage.h"
 #include <cmath>
 
-MixStage::MixStage()
+template <typename SampleType>
+MixStage<SampleType>::MixStage()
     : currentSampleRate(44100.0)
     , lastMixPercent(-1.0f)
     , smoothedMix(0.0f)
@@ -9,7 +10,8 @@ MixStage::MixStage()
 {
 }
 
-void MixStage::prepare(double sampleRate)
+template <typename SampleType>
+void MixStage<SampleType>::prepare(double sampleRate)
 {
     currentSampleRate = sampleRate;
     
@@ -20,13 +22,15 @@ void MixStage::prepare(double sampleRate)
     reset();
 }
 
-void MixStage::reset()
+template <typename SampleType>
+void MixStage<SampleType>::reset()
 {
     smoothedMix = 0.0f;
     lastMixPercent = -1.0f;
 }
 
-float MixStage::processSample(float drySample, float wetSample, float mixPercent)
+template <typename SampleType>
+SampleType MixStage<SampleType>::processSample(SampleType drySample, SampleType wetSample, float mixPercent)
 {
     // Clamp mix to valid range
     mixPercent = juce::jlimit(0.0f, 100.0f, mixPercent);
@@ -34,6 +38,12 @@ float MixStage::processSample(float drySample, float wetSample, float mixPercent
     // Convert percentage to 0-1 range
     float mixNormalized = mixPercent / 100.0f;
     
+    return processNormalized(drySample, wetSample, mixNormalized);
+}
+
+template <typename SampleType>
+SampleType MixStage<SampleType>::processNormalized(SampleType drySample, SampleType wetSample, float mixNormalized)
+{
     // Smooth parameter changes
     smoothedMix += smoothingCoeff * (mixNormalized - smoothedMix);
     
@@ -43,7 +53,35 @@ float MixStage::processSample(float drySample, float wetSample, float mixPercent
     float dryGain = std::cos(smoothedMix * juce::MathConstants<float>::halfPi);
     
     // Mix signals
-    float output = drySample * dryGain + wetSample * wetGain;
+    SampleType output = drySample * dryGain + wetSample * wetGain;
     
     return output;
 }
+
+template <typename SampleType>
+void MixStage<SampleType>::processBlock(const SampleType* dry, const SampleType* wet, SampleType* output,
+                                        int numSamples, float mixLevel)
+{
+    const float mixNormalized = juce::jlimit(0.0f, 1.0f, mixLevel);
+    
+    int i = 0;
+    
+    // While the smoother is still moving, gains have to follow it per sample
+    for (; i < numSamples && std::abs(mixNormalized - smoothedMix) > 1.0e-5f; ++i)
+        output[i] = processNormalized(dry[i], wet[i], mixNormalized);
+    
+    if (i == numSamples)
+        return;
+    
+    // Settled: snap to the target so the remainder uses constant gains
+    smoothedMix = mixNormalized;
+    
+    const float wetGain = std::sin(smoothedMix * juce::MathConstants<float>::halfPi);
+    const float dryGain = std::cos(smoothedMix * juce::MathConstants<float>::halfPi);
+    
+    for (; i < numSamples; ++i)
+        output[i] = dry[i] * dryGain + wet[i] * wetGain;
+}
+
+template class MixStage<float>;
+template class MixStage<LaneOps::FloatVector>;
@@ -1,12 +1,17 @@
 #pragma once
 
 #include <juce_core/juce_core.h>
+#include "LaneOps.h"
 
 /**
  * MixStage - Dry/Wet blending with level compensation
  * Implements final mixing stage with equal-power crossfade
  * Based on design doc: 0-100% mix with perceived loudness preservation
+ *
+ * SampleType is float for one channel, or LaneOps::FloatVector to mix every
+ * lane with the same (smoothed) gains.
  */
+template <typename SampleType>
 class MixStage
 {
 public:
@@ -26,7 +31,18 @@ public:
      * @param mixPercent Mix amount (0-100%: 0=all dry, 100=all wet)
      * @return Mixed output sample
      */
-    float processSample(float drySample, float wetSample, float mixPercent);
+    SampleType processSample(SampleType drySample, SampleType wetSample, float mixPercent);
+
+    /**
+     * Mix a block of dry and wet samples (output may alias either input)
+     * @param dry Original input signal
+     * @param wet Processed (delayed) signal
+     * @param output Destination for the mixed signal
+     * @param numSamples Number of samples to process
+     * @param mixLevel Mix amount (0-1: 0=all dry, 1=all wet)
+     */
+    void processBlock(const SampleType* dry, const SampleType* wet, SampleType* output,
+                      int numSamples, float mixLevel);
 
 private:
     double currentSampleRate;
@@ -36,5 +52,8 @@ private:
     float smoothedMix;
     float smoothingCoeff;
 
+    /** processSample for a mix already converted to 0-1 */
+    SampleType processNormalized(SampleType drySample, SampleType wetSample, float mixNormalized);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MixStage)
 };
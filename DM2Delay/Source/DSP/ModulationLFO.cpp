@@ -0,0 +1,86 @@
+#include "ModulationLFO.h"
+
+template <typename SampleType>
+ModulationLFO<SampleType>::ModulationLFO()
+    : currentSampleRate(44100.0)
+    , rate(0.0f)
+    , sinPhase(0.0)
+    , cosPhase(1.0)
+    , sinStep(0.0)
+    , cosStep(1.0)
+    , laneCos(LaneOps::broadcast<SampleType>(1.0f))
+    , laneSin(LaneOps::broadcast<SampleType>(0.0f))
+{
+}
+
+template <typename SampleType>
+float ModulationLFO<SampleType>::getDepthMs(float rateHz)
+{
+    if (rateHz <= 0.0f)
+        return 0.0f;
+    
+    // A delay swing of D seconds at f Hz bends pitch by up to 2 pi f D
+    const float depthMs = 1000.0f * pitchDeviation / (juce::MathConstants<float>::twoPi * rateHz);
+    return juce::jmin(maxDepthMs, depthMs);
+}
+
+template <typename SampleType>
+void ModulationLFO<SampleType>::prepare(double sampleRate)
+{
+    currentSampleRate = sampleRate;
+    
+    // Recompute the rotation for the new rate
+    const float currentRate = rate;
+    rate = -1.0f;
+    setRate(currentRate);
+    
+    reset();
+}
+
+template <typename SampleType>
+void ModulationLFO<SampleType>::reset()
+{
+    sinPhase = 0.0;
+    cosPhase = 1.0;
+}
+
+template <typename SampleType>
+void ModulationLFO<SampleType>::setLanePhaseSpread(float radians)
+{
+    for (size_t lane = 0; lane < numLanes; ++lane)
+    {
+        const float offset = radians * static_cast<float>(lane);
+        LaneOps::setLane(laneCos, lane, std::cos(offset));
+        LaneOps::setLane(laneSin, lane, std::sin(offset));
+    }
+}
+
+template <typename SampleType>
+void ModulationLFO<SampleType>::setRate(float rateHz)
+{
+    if (rateHz == rate)
+        return;
+    
+    rate = rateHz;
+    
+    const double angle = juce::MathConstants<double>::twoPi * rateHz * controlInterval / currentSampleRate;
+    sinStep = std::sin(angle);
+    cosStep = std::cos(angle);
+}
+
+template <typename SampleType>
+SampleType ModulationLFO<SampleType>::advance()
+{
+    // Rotate, then pull the radius back to 1 (rounding would otherwise drift it)
+    const double newSin = sinPhase * cosStep + cosPhase * sinStep;
+    const double newCos = cosPhase * cosStep - sinPhase * sinStep;
+    const double gain = 1.5 - 0.5 * (newSin * newSin + newCos * newCos);
+    
+    sinPhase = newSin * gain;
+    cosPhase = newCos * gain;
+    
+    return laneCos * static_cast<float>(sinPhase) + laneSin * static_cast<float>(cosPhase);
+}
+
+template class ModulationLFO<float>;
+template class ModulationLFO<LaneOps::FloatVector>;
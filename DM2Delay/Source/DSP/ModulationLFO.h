@@ -0,0 +1,75 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include "LaneOps.h"
+
+/**
+ * ModulationLFO - Control-rate sine LFO for BBD clock wobble
+ * A quadrature oscillator: the (sin, cos) pair is rotated by a fixed angle
+ * once per control step, so no trig runs while it plays (only when the rate
+ * changes), and a first-order gain correction keeps it on the unit circle.
+ *
+ * Every lane reads the same oscillator at its own phase offset,
+ * sin(theta + phi) = sin(theta) cos(phi) + cos(theta) sin(phi), so channels
+ * can wobble apart for stereo width at the cost of two multiplies.
+ *
+ * SampleType is float for one channel (or a shared clock), or
+ * LaneOps::FloatVector for one phase offset per lane.
+ */
+template <typename SampleType>
+class ModulationLFO
+{
+public:
+    ModulationLFO();
+    ~ModulationLFO() = default;
+
+    /** Host samples per control step; callers interpolate between steps */
+    static constexpr int controlInterval = 32;
+
+    /**
+     * Delay swing (peak, in ms) for a wobble rate: constant peak pitch
+     * deviation, so faster wobble stays a subtle chorus, capped at slow rates
+     */
+    static float getDepthMs(float rateHz);
+
+    /** Prepare for playback with given sample rate */
+    void prepare(double sampleRate);
+
+    /** Restart at phase zero */
+    void reset();
+
+    /** Phase offset between neighbouring lanes (channels), in radians */
+    void setLanePhaseSpread(float radians);
+
+    /** Set the rate in Hz (phase is continuous across changes) */
+    void setRate(float rateHz);
+
+    /**
+     * Advance one control step
+     * @return sin of the new phase in every lane (each at its own offset), in [-1, 1]
+     */
+    SampleType advance();
+
+private:
+    static constexpr size_t numLanes = LaneOps::numLanes<SampleType>();
+
+    // Peak pitch deviation of the wobble (0.5%, about 9 cents) and the swing cap
+    static constexpr float pitchDeviation = 0.005f;
+    static constexpr float maxDepthMs = 2.0f;
+
+    double currentSampleRate;
+    float rate;
+
+    // Oscillator state and its rotation per control step
+    double sinPhase;
+    double cosPhase;
+    double sinStep;
+    double cosStep;
+
+    // Per-lane phase offset as (cos, sin) pairs
+    SampleType laneCos;
+    SampleType laneSin;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulationLFO)
+};
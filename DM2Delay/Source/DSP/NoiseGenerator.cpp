@@ -0,0 +1,118 @@
+#include "NoiseGenerator.h"
+
+namespace
+{
+    /** splitmix32-style hash, used to spread one seed across the lanes */
+    juce::uint32 hashSeed(juce::uint32 x)
+    {
+        x += 0x9e3779b9u;
+        x = (x ^ (x >> 16)) * 0x85ebca6bu;
+        x = (x ^ (x >> 13)) * 0xc2b2ae35u;
+        return x ^ (x >> 16);
+    }
+
+    /** Advance an xorshift32 state and map it to a float in [-1, 1) */
+    inline float nextWhite(juce::uint32& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+
+        // Top 23 bits as the mantissa of a float in [2, 4), then shift down to [-1, 1)
+        const juce::uint32 bits = (state >> 9) | 0x40000000u;
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value - 3.0f;
+    }
+}
+
+template <typename SampleType>
+NoiseGenerator<SampleType>::NoiseGenerator()
+    : seed(static_cast<juce::uint32>(juce::Random::getSystemRandom().nextInt()))
+    , lastNoiseSample(LaneOps::broadcast<SampleType>(0.0f))
+{
+    reset();
+}
+
+template <typename SampleType>
+void NoiseGenerator<SampleType>::setSeed(juce::uint32 newSeed)
+{
+    seed = newSeed;
+    reset();
+}
+
+template <typename SampleType>
+void NoiseGenerator<SampleType>::reset()
+{
+    for (size_t lane = 0; lane < numLanes; ++lane)
+    {
+        // xorshift must never hold zero
+        auto state = hashSeed(getLaneSeed(seed, lane));
+        laneStates[lane] = state != 0 ? state : 0x6d2b79f5u;
+    }
+
+    pinkFilterState[0] = LaneOps::broadcast<SampleType>(0.0f);
+    pinkFilterState[1] = LaneOps::broadcast<SampleType>(0.0f);
+    pinkFilterState[2] = LaneOps::broadcast<SampleType>(0.0f);
+    lastNoiseSample = LaneOps::broadcast<SampleType>(0.0f);
+}
+
+template <typename SampleType>
+void NoiseGenerator<SampleType>::fillWhite(SampleType* white, int numSamples)
+{
+    // Samples are numLanes contiguous floats, so write lane values directly
+    auto* laneValues = reinterpret_cast<float*>(white);
+    auto states = laneStates; // local copy keeps the states in registers
+
+    for (int i = 0; i < numSamples; ++i)
+        for (size_t lane = 0; lane < numLanes; ++lane)
+            laneValues[static_cast<size_t>(i) * numLanes + lane] = nextWhite(states[lane]);
+
+    laneStates = states;
+}
+
+template <typename SampleType>
+SampleType NoiseGenerator<SampleType>::shape(SampleType white, float amplitude)
+{
+    // Simple pink noise filter (Paul Kellet's approach)
+    pinkFilterState[0] = pinkFilterState[0] * 0.99765f + white * 0.0990460f;
+    pinkFilterState[1] = pinkFilterState[1] * 0.96300f + white * 0.2965164f;
+    pinkFilterState[2] = pinkFilterState[2] * 0.57000f + white * 1.0526913f;
+
+    SampleType pink = pinkFilterState[0] + pinkFilterState[1] + pinkFilterState[2] + white * 0.1848f;
+
+    // Mix white and pink for BBD character (mostly pink); 0.088 = 0.8 * 0.11 pink normalisation
+    SampleType noise = (pink * 0.088f + white * 0.2f) * amplitude;
+
+    // Smooth noise slightly to avoid harsh digital artifacts
+    noise = lastNoiseSample * 0.3f + noise * 0.7f;
+    lastNoiseSample = noise;
+
+    return noise;
+}
+
+template <typename SampleType>
+SampleType NoiseGenerator<SampleType>::getNextSample(float amplitude)
+{
+    SampleType white;
+    fillWhite(&white, 1);
+    return shape(white, amplitude);
+}
+
+template <typename SampleType>
+void NoiseGenerator<SampleType>::addToBlock(SampleType* buffer, int numSamples, float amplitude)
+{
+    SampleType white[chunkSize];
+
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        const int count = juce::jmin(chunkSize, numSamples - start);
+        fillWhite(white, count);
+
+        for (int i = 0; i < count; ++i)
+            buffer[start + i] += shape(white[i], amplitude);
+    }
+}
+
+template class NoiseGenerator<float>;
+template class NoiseGenerator<LaneOps::FloatVector>;
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include "LaneOps.h"
+
+/**
+ * NoiseGenerator - Shaped BBD hiss (mostly pink, some white)
+ * White noise comes from one xorshift32 generator per lane, filled a block
+ * at a time so the generator loop vectorises; the Kellet pink filter and
+ * smoothing then run once per block in SampleType.
+ *
+ * Seeded generators replay the same noise after every reset(), so offline
+ * renders are reproducible.
+ */
+template <typename SampleType>
+class NoiseGenerator
+{
+public:
+    NoiseGenerator();
+    ~NoiseGenerator() = default;
+
+    /** Seed every lane (lanes get distinct, decorrelated streams) and reset */
+    void setSeed(juce::uint32 newSeed);
+
+    /** Restart the noise sequence from the seed and clear the filter state */
+    void reset();
+
+    /**
+     * Seed that makes a one-lane generator replay one lane of a generator seeded
+     * with seed (so scalar and SIMD renders can be compared sample for sample)
+     */
+    static juce::uint32 getLaneSeed(juce::uint32 seed, size_t lane) noexcept
+    {
+        return seed + static_cast<juce::uint32>(lane) * 0x632be5abu;
+    }
+
+    /**
+     * Generate one shaped noise sample
+     * @param amplitude Linear noise amplitude
+     */
+    SampleType getNextSample(float amplitude);
+
+    /**
+     * Add shaped noise to a block of samples
+     * @param buffer Samples to add noise to, in place
+     * @param numSamples Number of samples
+     * @param amplitude Linear noise amplitude for the whole block
+     */
+    void addToBlock(SampleType* buffer, int numSamples, float amplitude);
+
+private:
+    static constexpr size_t numLanes = LaneOps::numLanes<SampleType>();
+
+    // White noise is generated in chunks of this many samples on the stack
+    static constexpr int chunkSize = 64;
+
+    juce::uint32 seed;
+    std::array<juce::uint32, numLanes> laneStates;
+
+    // Simple pink noise filter (1/f approximation)
+    SampleType pinkFilterState[3];
+    SampleType lastNoiseSample;
+
+    /** Fill numSamples samples of uniform white noise in [-1, 1) */
+    void fillWhite(SampleType* white, int numSamples);
+
+    /** Pink-filter, blend and smooth one white sample */
+    SampleType shape(SampleType white, float amplitude);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NoiseGenerator)
+};
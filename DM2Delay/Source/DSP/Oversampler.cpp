@@ -0,0 +1,231 @@
+#include "Oversampler.h"
+
+namespace
+{
+    /** Zeroth-order modified Bessel function (Kaiser window) */
+    double besselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        
+        for (int k = 1; k < 32; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        
+        return sum;
+    }
+    
+    /** Push into a doubled ring so that ring[index .. index + length) is newest-first */
+    template <typename SampleType, size_t size>
+    inline void pushNewest(std::array<SampleType, size>& ring, int& index, int length, SampleType value)
+    {
+        index = (index == 0 ? length : index) - 1;
+        ring[static_cast<size_t>(index)] = value;
+        ring[static_cast<size_t>(index + length)] = value;
+    }
+    
+    /** Dot product of a newest-first window with the polyphase taps */
+    template <typename SampleType>
+    inline SampleType dot(const SampleType* window, const float* coefficients, int numTaps)
+    {
+        SampleType sum = window[0] * coefficients[0];
+        for (int tap = 1; tap < numTaps; ++tap)
+            sum += window[tap] * coefficients[tap];
+        return sum;
+    }
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::HalfBandStage::design(int newNumTaps, double kaiserBeta)
+{
+    jassert(newNumTaps % 2 == 0 && newNumTaps <= maxTaps);
+    numTaps = newNumTaps;
+    
+    // Kaiser-windowed half-band sinc of length 2 * numTaps - 1; the taps at even
+    // distance from the centre are zero, and the ones kept are h[2i]
+    const int length = 2 * numTaps - 1;
+    const int centre = numTaps - 1;
+    double sum = 0.0;
+    
+    for (int i = 0; i < numTaps; ++i)
+    {
+        const int k = 2 * i;
+        const double x = (k - centre) * 0.5;
+        const double sinc = std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+        const double ratio = (2.0 * k) / (length - 1) - 1.0;
+        const double window = besselI0(kaiserBeta * std::sqrt(juce::jmax(0.0, 1.0 - ratio * ratio))) / besselI0(kaiserBeta);
+        
+        coefficients[static_cast<size_t>(i)] = static_cast<float>(0.5 * sinc * window);
+        sum += 0.5 * sinc * window;
+    }
+    
+    // The polyphase branch sums to exactly 0.5 (the centre tap) for unity DC gain
+    for (int i = 0; i < numTaps; ++i)
+        coefficients[static_cast<size_t>(i)] = static_cast<float>(coefficients[static_cast<size_t>(i)] * 0.5 / sum);
+    
+    reset();
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::HalfBandStage::reset()
+{
+    upHistory.fill(LaneOps::broadcast<SampleType>(0.0f));
+    evenHistory.fill(LaneOps::broadcast<SampleType>(0.0f));
+    oddHistory.fill(LaneOps::broadcast<SampleType>(0.0f));
+    upIndex = 0;
+    evenIndex = 0;
+    oddIndex = 0;
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::HalfBandStage::upsample(const SampleType* input, SampleType* output, int numSamples)
+{
+    // Even outputs are the polyphase branch, odd outputs the centre tap (a pure
+    // delay of numTaps/2 - 1 input samples); both carry a gain of 2 for zero-stuffing
+    const int centreDelay = numTaps / 2 - 1;
+    
+    for (int i = 0; i < numSamples; ++i)
+    {
+        pushNewest(upHistory, upIndex, numTaps, input[i]);
+        const SampleType* window = upHistory.data() + upIndex;
+        
+        output[2 * i] = dot(window, coefficients.data(), numTaps) * 2.0f;
+        output[2 * i + 1] = window[centreDelay];
+    }
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::HalfBandStage::downsample(const SampleType* input, SampleType* output, int numSamples)
+{
+    // Even inputs go through the polyphase branch, odd inputs through the centre
+    // tap, numTaps/2 output samples back. In-place safe: output[i] only
+    // overwrites input samples that have already been read
+    const int centreDelay = numTaps / 2;
+    
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const SampleType even = input[2 * i];
+        const SampleType odd = input[2 * i + 1];
+        
+        pushNewest(evenHistory, evenIndex, numTaps, even);
+        pushNewest(oddHistory, oddIndex, numTaps, odd);
+        
+        output[i] = dot(evenHistory.data() + evenIndex, coefficients.data(), numTaps)
+                  + oddHistory[static_cast<size_t>(oddIndex + centreDelay)] * 0.5f;
+    }
+}
+
+template <typename SampleType>
+Oversampler<SampleType>::Oversampler()
+    : oversampledBlock(nullptr)
+    , padLength(0)
+    , padIndex(0)
+    , factorLog2(0)
+    , latencySamples(0)
+{
+    // First stage carries the steep transition (passband to ~0.41 of the host
+    // rate); later stages only reject images far above the audio band
+    stages[0].design(24, 8.0);
+    stages[1].design(12, 7.0);
+    stages[2].design(8, 6.0);
+    
+    setFactorLog2(0);
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::prepare(int maxBlockSize)
+{
+    const auto size = static_cast<size_t>(juce::jmax(1, maxBlockSize) << maxFactorLog2);
+    bufferA.assign(size, LaneOps::broadcast<SampleType>(0.0f));
+    bufferB.assign(size, LaneOps::broadcast<SampleType>(0.0f));
+    reset();
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::reset()
+{
+    for (auto& stage : stages)
+        stage.reset();
+    
+    padDelay.fill(LaneOps::broadcast<SampleType>(0.0f));
+    padIndex = 0;
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::setFactorLog2(int newFactorLog2)
+{
+    factorLog2 = juce::jlimit(0, maxFactorLog2, newFactorLog2);
+    
+    // Stage s runs at 2^s times the host rate, so its round trip costs
+    // delay / 2^s host samples; pad the remainder at the top rate
+    const int factor = getFactor();
+    int topRateDelay = 0;
+    
+    for (int stage = 0; stage < factorLog2; ++stage)
+        topRateDelay += stages[static_cast<size_t>(stage)].getRoundTripDelay() << (factorLog2 - stage);
+    
+    padLength = (factor - topRateDelay % factor) % factor;
+    latencySamples = (topRateDelay + padLength) / factor;
+    
+    jassert(padLength < static_cast<int>(padDelay.size()));
+    reset();
+}
+
+template <typename SampleType>
+SampleType* Oversampler<SampleType>::processSamplesUp(const SampleType* input, int numSamples)
+{
+    jassert((numSamples << factorLog2) <= static_cast<int>(bufferA.size()));
+    
+    // Ping-pong so the final stage always lands in bufferA
+    const SampleType* source = input;
+    SampleType* destination = (factorLog2 % 2 == 1) ? bufferA.data() : bufferB.data();
+    
+    if (factorLog2 == 0)
+        std::copy(input, input + numSamples, bufferA.data());
+    
+    for (int stage = 0; stage < factorLog2; ++stage)
+    {
+        stages[static_cast<size_t>(stage)].upsample(source, destination, numSamples << stage);
+        source = destination;
+        destination = (destination == bufferA.data()) ? bufferB.data() : bufferA.data();
+    }
+    
+    oversampledBlock = bufferA.data();
+    return oversampledBlock;
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::processSamplesDown(SampleType* output, int numSamples)
+{
+    jassert(oversampledBlock != nullptr);
+    
+    const int topRateSamples = numSamples << factorLog2;
+    
+    if (padLength > 0)
+    {
+        for (int i = 0; i < topRateSamples; ++i)
+        {
+            const SampleType delayed = padDelay[static_cast<size_t>(padIndex)];
+            padDelay[static_cast<size_t>(padIndex)] = oversampledBlock[i];
+            oversampledBlock[i] = delayed;
+            padIndex = (padIndex + 1) % padLength;
+        }
+    }
+    
+    if (factorLog2 == 0)
+    {
+        std::copy(oversampledBlock, oversampledBlock + numSamples, output);
+        return;
+    }
+    
+    // Down in place through every stage but the last, which writes the output
+    for (int stage = factorLog2 - 1; stage > 0; --stage)
+        stages[static_cast<size_t>(stage)].downsample(oversampledBlock, oversampledBlock, numSamples << stage);
+    
+    stages[0].downsample(oversampledBlock, output, numSamples);
+}
+
+template class Oversampler<float>;
+template class Oversampler<LaneOps::FloatVector>;
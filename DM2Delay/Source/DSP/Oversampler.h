@@ -0,0 +1,101 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <vector>
+#include "LaneOps.h"
+
+/**
+ * Oversampler - 1x/2x/4x/8x resampling around nonlinear sections
+ * Cascade of linear-phase polyphase half-band FIR stages. Each 2x stage
+ * filters at the lower rate only (half the taps are zero and the centre tap
+ * is a pure delay), and a short pad at the top rate keeps the round-trip
+ * latency a whole number of host samples so it can be reported to the host.
+ *
+ * Usage per block: processSamplesUp(), apply the nonlinearity to
+ * numSamples * getFactor() samples of the returned buffer, processSamplesDown().
+ *
+ * SampleType is float for one channel, or LaneOps::FloatVector to resample
+ * every lane with the same filters in one pass.
+ */
+template <typename SampleType>
+class Oversampler
+{
+public:
+    Oversampler();
+    ~Oversampler() = default;
+
+    static constexpr int maxFactorLog2 = 3; // 8x
+
+    /** Allocate the oversampled buffers for blocks of up to maxBlockSize host samples */
+    void prepare(int maxBlockSize);
+
+    /** Clear filter state */
+    void reset();
+
+    /** Select 1x (0), 2x (1), 4x (2) or 8x (3); resets the filters */
+    void setFactorLog2(int newFactorLog2);
+
+    /** Oversampling factor (1, 2, 4 or 8) */
+    int getFactor() const { return 1 << factorLog2; }
+
+    /** Round-trip latency in host samples */
+    int getLatencyInSamples() const { return latencySamples; }
+
+    /**
+     * Upsample a block into the internal buffer
+     * @return numSamples * getFactor() samples at the oversampled rate
+     */
+    SampleType* processSamplesUp(const SampleType* input, int numSamples);
+
+    /** Downsample the internal buffer (as processed in place) back into output */
+    void processSamplesDown(SampleType* output, int numSamples);
+
+private:
+    static constexpr int maxTaps = 24;
+
+    /**
+     * One 2x half-band stage of length 2 * numTaps - 1: numTaps non-zero
+     * polyphase taps plus the 0.5 centre tap (every other tap is zero)
+     */
+    struct HalfBandStage
+    {
+        int numTaps = 0;
+        std::array<float, maxTaps> coefficients{};
+
+        // Doubled rings (index and index + numTaps) so windows are contiguous, newest first
+        std::array<SampleType, maxTaps * 2> upHistory;
+        std::array<SampleType, maxTaps * 2> evenHistory;
+        std::array<SampleType, maxTaps * 2> oddHistory;
+        int upIndex = 0;
+        int evenIndex = 0;
+        int oddIndex = 0;
+
+        void design(int newNumTaps, double kaiserBeta);
+
+        /** Group delay of the up + down round trip, in samples at this stage's input rate */
+        int getRoundTripDelay() const { return numTaps - 1; }
+
+        void reset();
+
+        void upsample(const SampleType* input, SampleType* output, int numSamples);
+        void downsample(const SampleType* input, SampleType* output, int numSamples);
+    };
+
+    std::array<HalfBandStage, maxFactorLog2> stages;
+
+    // Two top-rate buffers: upsampling ping-pongs between them
+    std::vector<SampleType> bufferA;
+    std::vector<SampleType> bufferB;
+    SampleType* oversampledBlock;
+
+    // Top-rate delay that rounds the latency up to whole host samples
+    std::array<SampleType, 8> padDelay;
+    int padLength;
+    int padIndex;
+
+    int factorLog2;
+    int latencySamples;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Oversampler)
+};
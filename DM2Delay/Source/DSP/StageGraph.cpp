@@ -0,0 +1,220 @@
+#include "StageGraph.h"
+
+template <typename SampleType>
+StageGraph<SampleType>::StageGraph()
+    : numStages(0)
+    , currentSampleRate(44100.0)
+{
+    stageWasEnabled.fill(true);
+    stageWasSilent.fill(false);
+}
+
+template <typename SampleType>
+void StageGraph<SampleType>::prepare(double sampleRate, int maxBlockSize, int numStagesToPrepare,
+                                     float maxDelayMs, bool compactDelayStorage)
+{
+    currentSampleRate = sampleRate;
+    
+    const int requiredStages = juce::jlimit(1, maxStages, numStagesToPrepare);
+    if (requiredStages != numStages)
+    {
+        stages.reset(new Stage[static_cast<size_t>(requiredStages)]);
+        numStages = requiredStages;
+    }
+    
+    for (int stage = 0; stage < numStages; ++stage)
+        stages[stage].prepare(sampleRate, maxBlockSize, maxDelayMs, compactDelayStorage);
+    
+    const auto scratchSize = static_cast<size_t>(juce::jmax(1, maxBlockSize));
+    dryScratch.assign(scratchSize, LaneOps::broadcast<SampleType>(0.0f));
+    wetScratch.assign(scratchSize, LaneOps::broadcast<SampleType>(0.0f));
+    graphInput.assign(scratchSize, LaneOps::broadcast<SampleType>(0.0f));
+    branchSum.assign(scratchSize, LaneOps::broadcast<SampleType>(0.0f));
+    
+    // Freshly prepared stages are already clear
+    stageWasEnabled.fill(true);
+    stageWasSilent.fill(false);
+}
+
+template <typename SampleType>
+void StageGraph<SampleType>::reset()
+{
+    for (int stage = 0; stage < numStages; ++stage)
+        stages[stage].reset();
+    
+    stageWasEnabled.fill(true);
+    stageWasSilent.fill(false);
+}
+
+template <typename SampleType>
+void StageGraph<SampleType>::setNoiseSeed(juce::uint32 seed)
+{
+    // Distinct seed per stage so no two noise streams coincide
+    for (int stage = 0; stage < numStages; ++stage)
+        stages[stage].setNoiseSeed(seed + static_cast<juce::uint32>(stage));
+}
+
+template <typename SampleType>
+void StageGraph<SampleType>::setOversamplingFactorLog2(int factorLog2)
+{
+    for (int stage = 0; stage < numStages; ++stage)
+        stages[stage].setOversamplingFactorLog2(factorLog2);
+}
+
+template <typename SampleType>
+void StageGraph<SampleType>::setProfiling(bool shouldProfile)
+{
+    for (int stage = 0; stage < numStages; ++stage)
+        stages[stage].setProfiling(shouldProfile);
+}
+
+template <typename SampleType>
+void StageGraph<SampleType>::collectSectionCycles(int stageIndex, typename Stage::SectionCycles& total)
+{
+    if (stageIndex >= 0 && stageIndex < numStages)
+        stages[stageIndex].collectSectionCycles(total);
+}
+
+template <typename SampleType>
+int StageGraph<SampleType>::updateEnabledStages(const Patch& patch)
+{
+    const int stagesInUse = juce::jlimit(0, numStages, patch.numStages);
+    
+    // A stage that sat out holds stale echoes, so it comes back from silence
+    for (int stage = 0; stage < numStages; ++stage)
+    {
+        const bool enabled = stage < stagesInUse && patch.stages[static_cast<size_t>(stage)].enabled;
+        
+        if (enabled && ! stageWasEnabled[static_cast<size_t>(stage)])
+            stages[stage].reset();
+        
+        stageWasEnabled[static_cast<size_t>(stage)] = enabled;
+    }
+    
+    return stagesInUse;
+}
+
+template <typename SampleType>
+template <typename RenderFunction>
+void StageGraph<SampleType>::route(SampleType* frames, int numSamples, const Patch& patch, RenderFunction&& render)
+{
+    jassert(numSamples <= static_cast<int>(graphInput.size()));
+    
+    const int stagesInUse = updateEnabledStages(patch);
+    
+    if (patch.routing == Routing::series)
+    {
+        for (int stage = 0; stage < stagesInUse; ++stage)
+            if (patch.stages[static_cast<size_t>(stage)].enabled)
+                render(stage, frames);
+        
+        return;
+    }
+    
+    // Parallel: each branch starts from the graph input, and the outputs are averaged
+    std::copy(frames, frames + numSamples, graphInput.data());
+    int numBranches = 0;
+    
+    for (int stage = 0; stage < stagesInUse; ++stage)
+    {
+        if (! patch.stages[static_cast<size_t>(stage)].enabled)
+            continue;
+        
+        if (numBranches > 0)
+            std::copy(graphInput.data(), graphInput.data() + numSamples, frames);
+        
+        render(stage, frames);
+        
+        if (numBranches == 0)
+            std::copy(frames, frames + numSamples, branchSum.data());
+        else
+            for (int i = 0; i < numSamples; ++i)
+                branchSum[static_cast<size_t>(i)] += frames[i];
+        
+        ++numBranches;
+    }
+    
+    if (numBranches > 1)
+    {
+        const float branchGain = 1.0f / static_cast<float>(numBranches);
+        for (int i = 0; i < numSamples; ++i)
+            frames[i] = branchSum[static_cast<size_t>(i)] * branchGain;
+    }
+}
+
+template <typename SampleType>
+bool StageGraph<SampleType>::renderStage(int index, SampleType* frames, int numSamples, const Patch& patch,
+                                         bool inputIsIdleFloor)
+{
+    auto& stage = stages[index];
+    const auto& settings = patch.stages[static_cast<size_t>(index)];
+    
+    const int tailSamples = static_cast<int>(std::ceil((Stage::getTailSeconds(settings) + Stage::tailSettleSeconds)
+                                                       * currentSampleRate));
+    
+    // Silent input and no repeats left: the stage's output is its (silent) input,
+    // give or take the noise floor and what is left of the last repeat. An idle
+    // stage's noise floor is well above silenceLevel, so it counts as silence here
+    const bool silent = inputIsIdleFloor ? stage.updateSilence(numSamples, tailSamples)
+                                         : stage.updateSilence(frames, numSamples, tailSamples);
+    const bool wasSilent = stageWasSilent[static_cast<size_t>(index)];
+    stageWasSilent[static_cast<size_t>(index)] = silent;
+    
+    if (! silent)
+    {
+        stage.process(frames, numSamples, settings, dryScratch.data(), wetScratch.data());
+        
+        if (stage.getWetPeak() > levels.wetPeak)
+        {
+            levels.wetPeak = stage.getWetPeak();
+            levels.wetSumOfSquares = stage.getWetSumOfSquares();
+        }
+        
+        levels.compressionGain = juce::jmin(levels.compressionGain, stage.getCompressionGain());
+    }
+    else if (patch.idleNoiseFloor)
+        stage.processIdle(frames, numSamples, settings, dryScratch.data(), wetScratch.data());
+    else if (! wasSilent)
+        stage.processFadeOut(frames, numSamples, settings, dryScratch.data(), wetScratch.data());
+    
+    return silent;
+}
+
+template <typename SampleType>
+void StageGraph<SampleType>::process(SampleType* frames, int numSamples, const Patch& patch)
+{
+    levels = Levels();
+    
+    // In series an idle stage feeds the next one its noise floor; parallel branches all start from the graph input
+    bool inputIsIdleFloor = false;
+    
+    route(frames, numSamples, patch, [&](int stage, SampleType* stageFrames)
+    {
+        const bool idled = renderStage(stage, stageFrames, numSamples, patch, inputIsIdleFloor);
+        inputIsIdleFloor = idled && patch.routing == Routing::series;
+    });
+}
+
+template <typename SampleType>
+double StageGraph<SampleType>::getTailSeconds(const Patch& patch)
+{
+    // In series each stage keeps repeating the previous stage's tail, then adds
+    // its own; in parallel the longest branch decides
+    double repeatsSeconds = 0.0;
+    
+    for (int stage = 0; stage < juce::jlimit(0, maxStages, patch.numStages); ++stage)
+    {
+        const auto& settings = patch.stages[static_cast<size_t>(stage)];
+        if (! settings.enabled)
+            continue;
+        
+        const double stageSeconds = Stage::getTailSeconds(settings);
+        repeatsSeconds = patch.routing == Routing::series ? repeatsSeconds + stageSeconds
+                                                          : juce::jmax(repeatsSeconds, stageSeconds);
+    }
+    
+    return repeatsSeconds + Stage::tailSettleSeconds;
+}
+
+template class StageGraph<float>;
+template class StageGraph<LaneOps::FloatVector>;
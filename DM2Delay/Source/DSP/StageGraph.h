@@ -0,0 +1,132 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <memory>
+#include <vector>
+#include "LaneOps.h"
+#include "BBDStage.h"
+
+/**
+ * StageGraph - Routing of 1 to maxStages BBD stages
+ * Series: each stage processes the previous stage's output (the DM-2 cascade).
+ * Parallel: every stage processes the graph input, and the outputs are
+ * averaged so equal stages sound like one (multi-head patches).
+ *
+ * Routing is decided once per block, never per sample. Disabled stages are
+ * skipped outright and cleared when they come back on, and a stage whose
+ * input has been silent for its whole tail is skipped too, after one block
+ * fading its output into its input (it only renders its noise floor when
+ * that is wanted), so unused stages cost nothing. This is the plugin's only
+ * idle mechanism: it works per stage, so in series stage 1 rests while stage
+ * 2's repeats are still dying away. An idle stage's noise floor counts as
+ * silence for the stage after it in series, so the next stage can rest too.
+ *
+ * SampleType is float for one channel, or LaneOps::FloatVector to run the
+ * channels of one group side by side.
+ */
+template <typename SampleType>
+class StageGraph
+{
+public:
+    using Stage = BBDStage<SampleType>;
+    using Settings = typename Stage::Settings;
+
+    static constexpr int maxStages = 4;
+
+    enum class Routing
+    {
+        series,
+        parallel
+    };
+
+    /** What the stages rendered in the last process call, for metering */
+    struct Levels
+    {
+        float wetPeak = 0.0f;          // loudest stage's wet signal
+        float wetSumOfSquares = 0.0f;  // of the same stage, over lanes and samples
+        float compressionGain = 1.0f;  // lowest compressor gain of any stage (1 = no reduction)
+    };
+
+    /** Everything that configures the graph for one block */
+    struct Patch
+    {
+        std::array<Settings, maxStages> stages;
+        int numStages = 1;
+        Routing routing = Routing::series;
+        bool idleNoiseFloor = false; // silent stages keep rendering their noise floor
+    };
+
+    StageGraph();
+    ~StageGraph() = default;
+
+    /**
+     * Prepare for playback (allocates)
+     * @param numStagesToPrepare Stages to allocate, up to maxStages
+     * @param maxDelayMs Longest delay time the ring buffer engine must hold
+     * @param compactDelayStorage Store the rings as 16-bit fixed point rather than float
+     */
+    void prepare(double sampleRate, int maxBlockSize, int numStagesToPrepare,
+                 float maxDelayMs, bool compactDelayStorage);
+
+    /** Clear every stage */
+    void reset();
+
+    /** Fix the noise seeds for reproducible renders (stage k gets seed + k) */
+    void setNoiseSeed(juce::uint32 seed);
+
+    /** Oversampling factor of every stage's BBD saturation */
+    void setOversamplingFactorLog2(int factorLog2);
+
+    /** Time the sections of every stage (see BBDStage::setProfiling) */
+    void setProfiling(bool shouldProfile);
+
+    /** Add a stage's section cycles since the last collect to total, and restart its count */
+    void collectSectionCycles(int stageIndex, typename Stage::SectionCycles& total);
+
+    /** Render a block (at most the prepared block size) through the graph, in place */
+    void process(SampleType* frames, int numSamples, const Patch& patch);
+
+    /** Time until the graph's repeats have died away once the input stops, including settling */
+    static double getTailSeconds(const Patch& patch);
+
+    int getNumStages() const { return numStages; }
+
+    /** Levels of the last process call (stages skipped for silence don't count) */
+    const Levels& getLevels() const { return levels; }
+
+private:
+    std::unique_ptr<Stage[]> stages;
+    int numStages;
+    double currentSampleRate;
+
+    // Whether each stage ran in the last block, so a stage coming back on starts clean
+    std::array<bool, maxStages> stageWasEnabled;
+
+    // Whether each stage was skipped for silence in the last block
+    std::array<bool, maxStages> stageWasSilent;
+
+    // Scratch for one stage at a time, plus the graph input and branch sum for parallel routing
+    std::vector<SampleType> dryScratch;
+    std::vector<SampleType> wetScratch;
+    std::vector<SampleType> graphInput;
+    std::vector<SampleType> branchSum;
+
+    Levels levels;
+
+    /** Enabled stages in use this block (clears stages that were just switched on) */
+    int updateEnabledStages(const Patch& patch);
+
+    /**
+     * One stage in place, skipping it while its input is silent
+     * @param inputIsIdleFloor The input is an idle stage's output: silence plus at most its noise floor
+     * @return true if the stage idled, so its output is silence plus at most a noise floor
+     */
+    bool renderStage(int index, SampleType* frames, int numSamples, const Patch& patch, bool inputIsIdleFloor);
+
+    /** Run render(stageIndex, frames) for every enabled stage in the patch's routing */
+    template <typename RenderFunction>
+    void route(SampleType* frames, int numSamples, const Patch& patch, RenderFunction&& render);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StageGraph)
+};
@@ -0,0 +1,175 @@
+#include "HelperThread.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "RealtimeGuard.h"
+#include <chrono>
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+#if JUCE_MAC || JUCE_IOS
+ #include <dispatch/dispatch.h>
+#elif JUCE_WINDOWS
+ #include <windows.h>
+#else
+ #include <cerrno>
+ #include <semaphore.h>
+#endif
+
+namespace
+{
+    /** Tell the core we are busy-waiting (frees pipeline resources for a hyperthread sibling) */
+    inline void spinPause() noexcept
+    {
+       #if JUCE_INTEL
+        _mm_pause();
+       #endif
+    }
+}
+
+/**
+ * A counting semaphore whose signal() never takes a lock, unlike
+ * juce::WaitableEvent (a mutex and condition variable)
+ */
+class HelperThread::Semaphore
+{
+public:
+   #if JUCE_MAC || JUCE_IOS
+    Semaphore() : handle(dispatch_semaphore_create(0)) {}
+    ~Semaphore() { dispatch_release(handle); }
+    void signal() noexcept { dispatch_semaphore_signal(handle); }
+    void wait() noexcept { dispatch_semaphore_wait(handle, DISPATCH_TIME_FOREVER); }
+
+private:
+    dispatch_semaphore_t handle;
+   #elif JUCE_WINDOWS
+    Semaphore() : handle(CreateSemaphoreW(nullptr, 0, LONG_MAX, nullptr)) {}
+    ~Semaphore() { CloseHandle(handle); }
+    void signal() noexcept { ReleaseSemaphore(handle, 1, nullptr); }
+    void wait() noexcept { WaitForSingleObject(handle, INFINITE); }
+
+private:
+    HANDLE handle;
+   #else
+    Semaphore() { sem_init(&handle, 0, 0); }
+    ~Semaphore() { sem_destroy(&handle); }
+    void signal() noexcept { sem_post(&handle); }
+
+    void wait() noexcept
+    {
+        while (sem_wait(&handle) != 0 && errno == EINTR)
+        {
+        }
+    }
+
+private:
+    sem_t handle;
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE(Semaphore)
+};
+
+HelperThread::HelperThread()
+    : juce::Thread("DM2Delay helper"),
+      semaphore(std::make_unique<Semaphore>())
+{
+}
+
+HelperThread::~HelperThread()
+{
+    stop();
+}
+
+void HelperThread::start()
+{
+    if (isThreadRunning())
+        return;
+
+    state.store(idle);
+    sleeping.store(false);
+    startRealtimeThread(juce::Thread::RealtimeOptions{}.withPriority(10));
+}
+
+void HelperThread::stop()
+{
+    signalThreadShouldExit();
+    wake();
+    stopThread(1000);
+}
+
+void HelperThread::wake() noexcept
+{
+    if (sleeping.exchange(false))
+        semaphore->signal();
+}
+
+void HelperThread::post(JobFunction function, void* context) noexcept
+{
+    jassert(state.load(std::memory_order_relaxed) == idle);
+
+    job = function;
+    jobContext = context;
+    state.store(posted);
+    wake();
+}
+
+void HelperThread::join() noexcept
+{
+    int expected = posted;
+
+    // Not picked up yet: run it here rather than wait for the helper to wake
+    if (state.compare_exchange_strong(expected, claimed, std::memory_order_acquire))
+        job(jobContext);
+    else
+        while (state.load(std::memory_order_acquire) != done)
+            spinPause();
+
+    state.store(idle, std::memory_order_relaxed);
+}
+
+void HelperThread::run()
+{
+    using Clock = std::chrono::steady_clock;
+    const auto spinTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(spinSeconds));
+    auto spinUntil = Clock::now();
+
+    // FTZ/DAZ is per thread: the jobs run the same decaying filters and feedback as renderBlock
+    juce::ScopedNoDenormals noDenormals;
+
+    while (! threadShouldExit())
+    {
+        int expected = posted;
+
+        if (state.compare_exchange_strong(expected, claimed, std::memory_order_acquire))
+        {
+            {
+                // The job is audio-thread work, so the same rules apply here
+                RealtimeGuard::ScopedAudioThread realtimeGuard;
+                job(jobContext);
+            }
+
+            state.store(done, std::memory_order_release);
+            spinUntil = Clock::now() + spinTime;
+            continue;
+        }
+
+        if (Clock::now() < spinUntil)
+        {
+            spinPause();
+            continue;
+        }
+
+        // Announce the sleep before the last look, so a post() after that look is sure to wake us
+        sleeping.store(true);
+
+        if (state.load() != posted && ! threadShouldExit())
+        {
+            semaphore->wait();
+        }
+        else if (! sleeping.exchange(false))
+        {
+            // A post() saw the flag and signalled after all: take that signal so the next sleep is real
+            semaphore->wait();
+        }
+    }
+}
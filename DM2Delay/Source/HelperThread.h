@@ -0,0 +1,79 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <memory>
+
+/**
+ * HelperThread - A pre-spawned real-time thread that takes one job at a time
+ * off the audio thread
+ *
+ * The handoff is a single atomic state word. post() publishes a job with one
+ * store; the helper claims it with a compare-and-swap. join() claims the job
+ * itself if the helper has not got to it yet (it may be asleep or
+ * descheduled), and otherwise spins until the helper finishes. The audio
+ * thread therefore never locks, allocates, makes a system call or waits on
+ * a thread that isn't running its job.
+ *
+ * The helper spins for a short while after each job, when the next one is
+ * most likely, then sleeps on a semaphore until post() wakes it. Waking a
+ * sleeping helper is a semaphore post (a system call on some platforms, but
+ * never a lock); the audio thread does not wait for the wake to land, since
+ * join() runs the job itself if the helper is late. An idle helper costs no
+ * CPU time.
+ */
+class HelperThread : private juce::Thread
+{
+public:
+    /** A job: a plain function and its argument, so posting never allocates */
+    using JobFunction = void (*)(void* context);
+
+    HelperThread();
+    ~HelperThread() override;
+
+    /** Spawn the thread at real-time priority (message thread; does nothing if running) */
+    void start();
+
+    /** Stop and join the thread (message thread) */
+    void stop();
+
+    /** True between start() and stop() */
+    bool isRunning() const { return isThreadRunning(); }
+
+    /**
+     * Hand a job to the helper (audio thread; one job at a time)
+     * Every post() must be followed by join() before the next one
+     */
+    void post(JobFunction function, void* context) noexcept;
+
+    /** Return once the posted job has run, on whichever thread claimed it */
+    void join() noexcept;
+
+private:
+    enum State
+    {
+        idle,
+        posted,
+        claimed,
+        done
+    };
+
+    std::atomic<int> state{idle};
+    JobFunction job = nullptr;
+    void* jobContext = nullptr;
+
+    // The helper's sleep: sleeping is set while it waits (or is about to) on the semaphore
+    class Semaphore;
+    std::unique_ptr<Semaphore> semaphore;
+    std::atomic<bool> sleeping{false};
+
+    // How long the helper keeps spinning after a job before it goes to sleep
+    static constexpr double spinSeconds = 0.002;
+
+    void run() override;
+
+    /** Wake the helper if it is asleep (any thread) */
+    void wake() noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HelperThread)
+};
@@ -0,0 +1,54 @@
+#include "Meters.h"
+#include <cmath>
+
+void Meters::Levels::add(const Levels& other) noexcept
+{
+    inputPeak = juce::jmax(inputPeak, other.inputPeak);
+    inputSumOfSquares += other.inputSumOfSquares;
+    wetPeak = juce::jmax(wetPeak, other.wetPeak);
+    wetSumOfSquares += other.wetSumOfSquares;
+    compressionGain = juce::jmin(compressionGain, other.compressionGain);
+    numChannelSamples += other.numChannelSamples;
+}
+
+void Meters::publish(const Levels& block) noexcept
+{
+    // The editor has taken what was there (or isn't reading at all): start a new accumulation
+    if (readSinceLastBlock.exchange(false, std::memory_order_acquire)
+        || accumulated.numChannelSamples > maxAccumulatedSamples)
+        accumulated = Levels();
+
+    accumulated.add(block);
+
+    const float scale = 1.0f / static_cast<float>(juce::jmax(1, accumulated.numChannelSamples));
+
+    inputPeak.store(accumulated.inputPeak, std::memory_order_relaxed);
+    inputRms.store(std::sqrt(accumulated.inputSumOfSquares * scale), std::memory_order_relaxed);
+    wetPeak.store(accumulated.wetPeak, std::memory_order_relaxed);
+    wetRms.store(std::sqrt(accumulated.wetSumOfSquares * scale), std::memory_order_relaxed);
+    gainReductionDb.store(juce::jmax(0.0f, -20.0f * std::log10(juce::jmax(1.0e-6f, accumulated.compressionGain))),
+                          std::memory_order_relaxed);
+    blocksPublished.fetch_add(1, std::memory_order_release);
+}
+
+Meters::Reading Meters::read() noexcept
+{
+    Reading reading;
+
+    const auto blocks = blocksPublished.load(std::memory_order_acquire);
+    reading.fresh = blocks != blocksAtLastRead;
+    blocksAtLastRead = blocks;
+
+    // Nothing rendered since the last read (transport stopped, fully bypassed): nothing to show
+    if (! reading.fresh)
+        return reading;
+
+    reading.inputPeak = inputPeak.load(std::memory_order_relaxed);
+    reading.inputRms = inputRms.load(std::memory_order_relaxed);
+    reading.wetPeak = wetPeak.load(std::memory_order_relaxed);
+    reading.wetRms = wetRms.load(std::memory_order_relaxed);
+    reading.gainReductionDb = gainReductionDb.load(std::memory_order_relaxed);
+
+    readSinceLastBlock.store(true, std::memory_order_release);
+    return reading;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+
+/**
+ * Meters - Levels the audio thread publishes for the editor
+ *
+ * One atomic slot per reading, so publishing is the same handful of stores
+ * every block: it never waits on, or slows down with, the GUI. Between two
+ * reads the slots accumulate (peaks and gain reduction hold their maximum,
+ * RMS covers every block since), so transients that fall between editor
+ * frames still show. The reader flags each read, and the writer starts
+ * afresh on its next block.
+ */
+class Meters
+{
+public:
+    /** What one block rendered, summed over channels (filled on the audio thread) */
+    struct Levels
+    {
+        float inputPeak = 0.0f;
+        float inputSumOfSquares = 0.0f;
+        float wetPeak = 0.0f;
+        float wetSumOfSquares = 0.0f;
+        float compressionGain = 1.0f; // lowest compressor gain (1 = no reduction)
+        int numChannelSamples = 0;    // samples times channels behind the sums of squares
+
+        /** Fold another set of levels (another channel group or chunk) into this one */
+        void add(const Levels& other) noexcept;
+    };
+
+    /** What the editor shows: everything since its previous read */
+    struct Reading
+    {
+        float inputPeak = 0.0f;
+        float inputRms = 0.0f;
+        float wetPeak = 0.0f;
+        float wetRms = 0.0f;
+        float gainReductionDb = 0.0f;
+        bool fresh = false; // false: no block was rendered since the previous read
+    };
+
+    Meters() = default;
+    ~Meters() = default;
+
+    /** Add one block (audio thread; wait-free) */
+    void publish(const Levels& block) noexcept;
+
+    /** Take the levels accumulated since the previous read (message thread; wait-free) */
+    Reading read() noexcept;
+
+private:
+    // Published slots
+    std::atomic<float> inputPeak{0.0f};
+    std::atomic<float> inputRms{0.0f};
+    std::atomic<float> wetPeak{0.0f};
+    std::atomic<float> wetRms{0.0f};
+    std::atomic<float> gainReductionDb{0.0f};
+    std::atomic<juce::uint32> blocksPublished{0};
+    std::atomic<bool> readSinceLastBlock{false};
+
+    // Accumulated since the last read (audio thread only)
+    Levels accumulated;
+
+    // With no editor reading, the sums restart about every ten seconds of stereo audio
+    static constexpr int maxAccumulatedSamples = 1 << 20;
+
+    // Reader only
+    juce::uint32 blocksAtLastRead = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Meters)
+};
@@ -0,0 +1,62 @@
+#include "ParameterSnapshot.h"
+
+ParameterHandles::ParameterHandles(juce::AudioProcessorValueTreeState& apvts)
+{
+    const juce::String stageIDs[Parameters::numStages][5] =
+    {
+        { Parameters::delayTimeID, Parameters::feedbackID, Parameters::mixID, Parameters::toneID, Parameters::modulationID },
+        { Parameters::delayTime2ID, Parameters::feedback2ID, Parameters::mix2ID, Parameters::tone2ID, Parameters::modulation2ID }
+    };
+
+    const juce::String longDelayTimeIDs[Parameters::numStages] = { Parameters::delayTimeLongID, Parameters::delayTimeLong2ID };
+
+    for (size_t stage = 0; stage < stages.size(); ++stage)
+    {
+        stages[stage].delayTime = apvts.getRawParameterValue(stageIDs[stage][0]);
+        stages[stage].delayTimeLong = apvts.getRawParameterValue(longDelayTimeIDs[stage]);
+        stages[stage].feedback = apvts.getRawParameterValue(stageIDs[stage][1]);
+        stages[stage].mix = apvts.getRawParameterValue(stageIDs[stage][2]);
+        stages[stage].tone = apvts.getRawParameterValue(stageIDs[stage][3]);
+        stages[stage].modulation = apvts.getRawParameterValue(stageIDs[stage][4]);
+    }
+
+    mode = apvts.getRawParameterValue(Parameters::modeID);
+    engine = apvts.getRawParameterValue(Parameters::engineID);
+    routing = apvts.getRawParameterValue(Parameters::routingID);
+    oversampling = apvts.getRawParameterValue(Parameters::oversamplingID);
+    bypass = apvts.getRawParameterValue(Parameters::bypassID);
+    trails = apvts.getRawParameterValue(Parameters::trailsID);
+    longDelay = apvts.getRawParameterValue(Parameters::longDelayID);
+}
+
+ParameterSnapshot ParameterSnapshot::capture(const ParameterHandles& handles, double sampleRate) noexcept
+{
+    // Relaxed is enough: each value is independent, and a change landing mid-capture
+    // is simply picked up in full next block
+    auto load = [](const std::atomic<float>* value) { return value->load(std::memory_order_relaxed); };
+
+    ParameterSnapshot snapshot;
+    const bool longDelay = load(handles.longDelay) > 0.5f;
+
+    for (size_t stage = 0; stage < snapshot.stages.size(); ++stage)
+    {
+        const auto& source = handles.stages[stage];
+        auto& values = snapshot.stages[stage];
+
+        values.delayTimeMs = load(longDelay ? source.delayTimeLong : source.delayTime);
+        values.delaySamples = Parameters::toDelaySamples(values.delayTimeMs, sampleRate);
+        values.feedbackGain = Parameters::toFeedbackGain(load(source.feedback));
+        values.mixLevel = Parameters::toMixLevel(load(source.mix));
+        values.tone = load(source.tone);
+        values.modulationHz = load(source.modulation);
+    }
+
+    snapshot.customMode = load(handles.mode) > 0.5f;
+    snapshot.clockedEngine = load(handles.engine) > 0.5f;
+    snapshot.parallelRouting = load(handles.routing) > 0.5f;
+    snapshot.oversamplingFactorLog2 = static_cast<int>(load(handles.oversampling));
+    snapshot.bypass = load(handles.bypass) > 0.5f;
+    snapshot.trails = load(handles.trails) > 0.5f;
+
+    return snapshot;
+}
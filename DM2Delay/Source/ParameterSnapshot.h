@@ -0,0 +1,71 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
+#include <atomic>
+#include <type_traits>
+#include "Parameters.h"
+
+/**
+ * ParameterHandles - Every parameter's value atomic, looked up by ID once
+ * Built in the processor's constructor, so nothing on the audio thread does a
+ * String-keyed lookup.
+ */
+struct ParameterHandles
+{
+    explicit ParameterHandles(juce::AudioProcessorValueTreeState& apvts);
+
+    struct Stage
+    {
+        std::atomic<float>* delayTime = nullptr;
+        std::atomic<float>* delayTimeLong = nullptr;
+        std::atomic<float>* feedback = nullptr;
+        std::atomic<float>* mix = nullptr;
+        std::atomic<float>* tone = nullptr;
+        std::atomic<float>* modulation = nullptr;
+    };
+
+    std::array<Stage, Parameters::numStages> stages;
+    std::atomic<float>* mode = nullptr;
+    std::atomic<float>* engine = nullptr;
+    std::atomic<float>* routing = nullptr;
+    std::atomic<float>* oversampling = nullptr;
+    std::atomic<float>* bypass = nullptr;
+    std::atomic<float>* trails = nullptr;
+    std::atomic<float>* longDelay = nullptr;
+};
+
+/**
+ * ParameterSnapshot - Every parameter value one block needs, loaded once
+ *
+ * capture() does one relaxed load per parameter and precomputes what the
+ * stages use (feedback and mix as 0-1 gains, delay time in samples), so the
+ * fixed per-block cost stays small at 32-64 sample buffers. The snapshot is
+ * trivially copyable: pass it by value, or share it with the helper thread.
+ */
+struct ParameterSnapshot
+{
+    struct Stage
+    {
+        float delayTimeMs = Parameters::delayTimeDefault;   // from whichever range is selected
+        float delaySamples = 0.0f;
+        float feedbackGain = 0.0f;
+        float mixLevel = 0.0f;
+        float tone = Parameters::toneDefault;   // %
+        float modulationHz = 0.0f;
+    };
+
+    std::array<Stage, Parameters::numStages> stages;
+    bool customMode = false;
+    bool clockedEngine = false;
+    bool parallelRouting = false;
+    int oversamplingFactorLog2 = 0;
+    bool bypass = false;
+    bool trails = false;
+
+    /** Load every parameter and derive the stage values (any thread; wait-free) */
+    static ParameterSnapshot capture(const ParameterHandles& handles, double sampleRate) noexcept;
+};
+
+static_assert(std::is_trivially_copyable<ParameterSnapshot>::value,
+              "ParameterSnapshot is copied per block and must stay a plain bundle of values");
@@ -18,6 +18,26 @@ namespace Parameters
     // Mode parameter
     const juce::String modeID = "mode"; // 0 = Standard, 1 = Custom
     
+    // Delay engine (both stages)
+    const juce::String engineID = "engine"; // 0 = Digital ring buffer, 1 = Clocked BBD
+    
+    // How the stages connect in custom mode
+    const juce::String routingID = "routing"; // choice index: 0 = Series (cascade), 1 = Parallel
+
+    // Oversampling around the nonlinear stages (both stages and the output clip)
+    const juce::String oversamplingID = "oversampling"; // choice index: 1x, 2x, 4x, 8x
+    
+    // Bypass (also the host's bypass) and whether the repeats ring out through it
+    const juce::String bypassID = "bypass";
+    const juce::String trailsID = "trails";
+
+    // Delay range (both stages): off, each stage takes its delay from delayTime (the pedal's
+    // 20-300 ms); on, from delayTimeLong (up to 2 s). Separate parameters, so the classic
+    // knobs keep the range their saved automation and controller mappings were made with
+    const juce::String longDelayID = "longDelay";
+    const juce::String delayTimeLongID = "delayTimeLong";
+    const juce::String delayTimeLong2ID = "delayTimeLong2";
+    
     // Parameter IDs - Stage 2 (second pedal in cascaded mode)
     const juce::String delayTime2ID = "delayTime2";
     const juce::String feedback2ID = "feedback2";
@@ -25,11 +45,16 @@ namespace Parameters
     const juce::String tone2ID = "tone2";
     const juce::String modulation2ID = "modulation2";
 
+    // Stages with their own set of parameters above
+    const int numStages = 2;
+
     // Parameter ranges (from design doc)
     const float delayTimeMin = 20.0f;    // ms
     const float delayTimeMax = 300.0f;   // ms
     const float delayTimeDefault = 100.0f;
 
+    const float delayTimeLongMax = 2000.0f;  // ms, also the longest delay the engines hold
+
     const float feedbackMin = 0.0f;      // %
     const float feedbackMax = 95.0f;     // %
     const float feedbackDefault = 30.0f;
@@ -46,6 +71,32 @@ namespace Parameters
     const float modulationMax = 10.0f;   // Hz
     const float modulationDefault = 0.0f;
 
+    /** Feedback (%) as the gain the delay engines apply, clamped to the safe 0-0.95 */
+    inline float toFeedbackGain(float feedbackPercent)
+    {
+        return juce::jlimit(0.0f, 0.95f, feedbackPercent / 100.0f);
+    }
+
+    /** Mix (%) as the 0-1 crossfade position */
+    inline float toMixLevel(float mixPercent)
+    {
+        return juce::jlimit(0.0f, 100.0f, mixPercent) / 100.0f;
+    }
+
+    /** Delay time (ms) in samples at sampleRate */
+    inline float toDelaySamples(float delayTimeMs, double sampleRate)
+    {
+        return (delayTimeMs / 1000.0f) * static_cast<float>(sampleRate);
+    }
+
+    /** Long delay time range: the pedal's 20-300 ms on the first half of the knob, up to 2 s beyond */
+    inline juce::NormalisableRange<float> createLongDelayTimeRange()
+    {
+        juce::NormalisableRange<float> range(delayTimeMin, delayTimeLongMax, 1.0f);
+        range.setSkewForCentre(delayTimeMax);
+        return range;
+    }
+
     // Helper to create parameter layout
     inline juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout()
     {
@@ -88,6 +139,34 @@ namespace Parameters
             0.0f, // Default to standard mode
             ""));
 
+        // Delay engine parameter
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            engineID, "Engine",
+            juce::NormalisableRange<float>(0.0f, 1.0f, 1.0f),
+            0.0f, // Default to the digital ring buffer
+            ""));
+
+        // Routing parameter
+        layout.add(std::make_unique<juce::AudioParameterChoice>(
+            routingID, "Routing",
+            juce::StringArray { "Series", "Parallel" },
+            0)); // Default to the DM-2 cascade
+
+        // Oversampling parameter
+        layout.add(std::make_unique<juce::AudioParameterChoice>(
+            oversamplingID, "Oversampling",
+            juce::StringArray { "1x", "2x", "4x", "8x" },
+            0)); // Default to no oversampling (zero latency)
+
+        // Bypass parameters
+        layout.add(std::make_unique<juce::AudioParameterBool>(
+            bypassID, "Bypass",
+            false));
+
+        layout.add(std::make_unique<juce::AudioParameterBool>(
+            trailsID, "Bypass Trails",
+            false)); // Default to cutting the repeats on bypass, like the pedal
+
         // Stage 2 parameters (for cascaded mode)
         layout.add(std::make_unique<juce::AudioParameterFloat>(
             delayTime2ID, "Delay Time 2",
@@ -119,6 +198,23 @@ namespace Parameters
             modulationDefault,
             "Hz"));
 
+        // Long delay parameters (added after the rest, so existing parameter indices stay put)
+        layout.add(std::make_unique<juce::AudioParameterBool>(
+            longDelayID, "Long Delay",
+            false)); // Default to the pedal's range
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            delayTimeLongID, "Delay Time (Long)",
+            createLongDelayTimeRange(),
+            delayTimeDefault,
+            "ms"));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            delayTimeLong2ID, "Delay Time 2 (Long)",
+            createLongDelayTimeRange(),
+            delayTimeDefault,
+            "ms"));
+
         return layout;
     }
 }
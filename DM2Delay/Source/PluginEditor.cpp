@@ -2,11 +2,14 @@
 #include "PluginEditor.h"
 
 DM2DelayAudioProcessorEditor::DM2DelayAudioProcessorEditor(DM2DelayAudioProcessor& p)
-    : AudioProcessorEditor(&p), audioProcessor(p)
+    : AudioProcessorEditor(&p), audioProcessor(p), profilerOverlay(p.getProfiler())
 {
-    // Start with single pedal size
-    setSize(400, 520);
-    setResizable(false, false); // Fixed size based on mode
+    // Start with single pedal size; resizable, keeping each mode's proportions (see updateSizeForMode)
+    setSize(pedalWidth, pedalHeight);
+    setResizable(true, true);
+
+    // The cached artwork covers the whole window, so nothing behind the editor needs painting
+    setOpaque(true);
 
     // === MAIN CONTROLS (Top section knobs) ===
     
@@ -19,8 +22,6 @@ DM2DelayAudioProcessorEditor::DM2DelayAudioProcessorEditor(DM2DelayAudioProcesso
     delayTimeLabel.setColour(juce::Label::textColourId, juce::Colours::white);
     delayTimeLabel.attachToComponent(&delayTimeKnob, false);
     addAndMakeVisible(delayTimeLabel);
-    delayTimeAttachment.reset(new juce::AudioProcessorValueTreeState::SliderAttachment(
-        audioProcessor.getAPVTS(), Parameters::delayTimeID, delayTimeKnob));
 
     // Feedback knob
     feedbackKnob.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
@@ -85,8 +86,6 @@ DM2DelayAudioProcessorEditor::DM2DelayAudioProcessorEditor(DM2DelayAudioProcesso
     delayTime2Label.setColour(juce::Label::textColourId, juce::Colours::white);
     delayTime2Label.attachToComponent(&delayTime2Knob, false);
     addAndMakeVisible(delayTime2Label);
-    delayTime2Attachment.reset(new juce::AudioProcessorValueTreeState::SliderAttachment(
-        audioProcessor.getAPVTS(), Parameters::delayTime2ID, delayTime2Knob));
 
     // Feedback 2 knob
     feedback2Knob.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
@@ -142,9 +141,10 @@ DM2DelayAudioProcessorEditor::DM2DelayAudioProcessorEditor(DM2DelayAudioProcesso
     bypassButton.setButtonText("");
     bypassButton.onClick = [this]()
     {
-        isBypassed = !isBypassed;
+        // The host may have toggled bypass since the last click
+        isBypassed = !audioProcessor.getBypass();
         audioProcessor.setBypass(isBypassed);
-        repaint();
+        repaintBypassIndicators();
     };
     addAndMakeVisible(bypassButton);
 
@@ -175,24 +175,335 @@ DM2DelayAudioProcessorEditor::DM2DelayAudioProcessorEditor(DM2DelayAudioProcesso
     
     // Initialize bypass state from processor
     isBypassed = audioProcessor.getBypass();
+
+    // Delay knobs follow the selected delay range
+    isLongDelay = audioProcessor.getAPVTS().getRawParameterValue(Parameters::longDelayID)->load() > 0.5f;
+    attachDelayTimeKnobs();
+
+    // === METERS (first pedal, opposite the internal trims) ===
+    addAndMakeVisible(meterPanel);
+
+    // === PROFILER OVERLAY (hidden; stays up across editor reopenings while profiling) ===
+    addChildComponent(profilerOverlay);
+    setProfilerVisible(audioProcessor.getProfiler().isEnabled());
+    setWantsKeyboardFocus(true);
+
+    startTimerHz(meterFrameRate);
 }
 
 DM2DelayAudioProcessorEditor::~DM2DelayAudioProcessorEditor()
 {
+    stopTimer();
 }
 
-void DM2DelayAudioProcessorEditor::updateSizeForMode()
+void DM2DelayAudioProcessorEditor::timerCallback()
 {
-    if (isCustomMode)
+    meterPanel.update(audioProcessor.getMeters().read());
+
+    if (profilerOverlay.isVisible())
+        profilerOverlay.update();
+
+    // Host automation and preset recalls change these without a click
+    const bool bypassed = audioProcessor.getBypass();
+    if (bypassed != isBypassed)
     {
-        // Custom mode: Show two pedals side by side with cable connection
-        setSize(800, 520); // 2x width for dual pedals
+        isBypassed = bypassed;
+        repaintBypassIndicators();
     }
-    else
+
+    const bool longDelay = audioProcessor.getAPVTS().getRawParameterValue(Parameters::longDelayID)->load() > 0.5f;
+    if (longDelay != isLongDelay)
+    {
+        isLongDelay = longDelay;
+        attachDelayTimeKnobs();
+    }
+
+    const bool customMode = audioProcessor.getAPVTS().getRawParameterValue(Parameters::modeID)->load() > 0.5f;
+    if (customMode != isCustomMode)
+    {
+        isCustomMode = customMode;
+        updateSizeForMode();
+        repaint();
+    }
+}
+
+void DM2DelayAudioProcessorEditor::attachDelayTimeKnobs()
+{
+    // Drop the old attachments first, so a knob is never attached to two parameters
+    delayTimeAttachment.reset();
+    delayTime2Attachment.reset();
+
+    delayTimeAttachment.reset(new juce::AudioProcessorValueTreeState::SliderAttachment(
+        audioProcessor.getAPVTS(), isLongDelay ? Parameters::delayTimeLongID : Parameters::delayTimeID, delayTimeKnob));
+    delayTime2Attachment.reset(new juce::AudioProcessorValueTreeState::SliderAttachment(
+        audioProcessor.getAPVTS(), isLongDelay ? Parameters::delayTimeLong2ID : Parameters::delayTime2ID, delayTime2Knob));
+}
+
+bool DM2DelayAudioProcessorEditor::keyPressed(const juce::KeyPress& key)
+{
+    const auto profilerKey = juce::KeyPress('p', juce::ModifierKeys::commandModifier | juce::ModifierKeys::shiftModifier, 0);
+
+    if (key == profilerKey)
+    {
+        setProfilerVisible(! profilerOverlay.isVisible());
+        return true;
+    }
+
+    return false;
+}
+
+void DM2DelayAudioProcessorEditor::setProfilerVisible(bool shouldBeVisible)
+{
+    audioProcessor.getProfiler().setEnabled(shouldBeVisible);
+    profilerOverlay.setVisible(shouldBeVisible);
+
+    if (shouldBeVisible)
+        profilerOverlay.toFront(false);
+}
+
+void DM2DelayAudioProcessorEditor::repaintBypassIndicators()
+{
+    for (int xOffset = 0; xOffset < getDesignWidth(); xOffset += pedalWidth)
     {
-        // Standard mode: Single pedal
-        setSize(400, 520);
+        repaintDesignArea({ xOffset + 190, 25, 20, 20 });   // LED
+        repaintDesignArea({ xOffset, 380, 400, 100 });      // footswitch
     }
+}
+
+void DM2DelayAudioProcessorEditor::repaintDesignArea(juce::Rectangle<int> area)
+{
+    repaint(area.toFloat().transformedBy(juce::AffineTransform::scale(uiScale)).getSmallestIntegerContainer());
+}
+
+const juce::Image& DM2DelayAudioProcessorEditor::getArtwork(float pixelScale)
+{
+    const size_t mode = isCustomMode ? 1 : 0;
+    auto& image = artwork[mode];
+
+    // Only a new window size or display scale re-rasterizes; meter frames and bypass clicks reuse it
+    if (image.isNull() || artworkPixelScale[mode] != pixelScale)
+    {
+        image = juce::Image(juce::Image::RGB,
+                            juce::roundToInt(static_cast<float>(getDesignWidth()) * pixelScale),
+                            juce::roundToInt(static_cast<float>(pedalHeight) * pixelScale),
+                            false);
+        artworkPixelScale[mode] = pixelScale;
+
+        juce::Graphics imageGraphics(image);
+        imageGraphics.addTransform(juce::AffineTransform::scale(pixelScale));
+        drawArtwork(imageGraphics);
+    }
+
+    return image;
+}
+
+DM2DelayAudioProcessorEditor::MeterPanel::MeterPanel()
+    : inputRmsDb(floorDb)
+    , inputPeakDb(floorDb)
+    , wetRmsDb(floorDb)
+    , wetPeakDb(floorDb)
+    , gainReductionDb(0.0f)
+{
+    // Paints its own background, so nothing behind it is redrawn with it
+    setOpaque(true);
+    setInterceptsMouseClicks(false, false);
+}
+
+void DM2DelayAudioProcessorEditor::MeterPanel::update(const Meters::Reading& reading)
+{
+    // Rise at once, fall at a fixed rate (a reading that isn't fresh is silence)
+    bool changed = false;
+    auto follow = [&changed](float& shown, float target)
+    {
+        const float next = juce::jmax(target, shown - fallDbPerFrame);
+        if (std::abs(next - shown) > 0.05f)
+            changed = true;
+        shown = next;
+    };
+
+    follow(inputRmsDb, juce::Decibels::gainToDecibels(reading.inputRms, floorDb));
+    follow(inputPeakDb, juce::Decibels::gainToDecibels(reading.inputPeak, floorDb));
+    follow(wetRmsDb, juce::Decibels::gainToDecibels(reading.wetRms, floorDb));
+    follow(wetPeakDb, juce::Decibels::gainToDecibels(reading.wetPeak, floorDb));
+    follow(gainReductionDb, juce::jmin(maxGainReductionDb, reading.gainReductionDb));
+
+    if (changed)
+        repaint();
+}
+
+void DM2DelayAudioProcessorEditor::MeterPanel::paint(juce::Graphics& g)
+{
+    // Same enclosure red as the pedal behind it
+    g.fillAll(juce::Colour(0xffa8273e));
+
+    auto levelProportion = [](float db) { return juce::jlimit(0.0f, 1.0f, (db - floorDb) / -floorDb); };
+
+    auto area = getLocalBounds();
+    const int rowHeight = area.getHeight() / 3;
+
+    drawMeter(g, area.removeFromTop(rowHeight), "IN",
+              levelProportion(inputRmsDb), levelProportion(inputPeakDb), juce::Colour(0xff60d060));
+    drawMeter(g, area.removeFromTop(rowHeight), "GR",
+              gainReductionDb / maxGainReductionDb, -1.0f, juce::Colour(0xffffb030));
+    drawMeter(g, area, "WET",
+              levelProportion(wetRmsDb), levelProportion(wetPeakDb), juce::Colour(0xff60d060));
+}
+
+void DM2DelayAudioProcessorEditor::MeterPanel::drawMeter(juce::Graphics& g, juce::Rectangle<int> row,
+                                                         const juce::String& label, float fillProportion,
+                                                         float peakProportion, juce::Colour colour)
+{
+    g.setColour(juce::Colours::white.withAlpha(0.7f));
+    g.setFont(juce::Font(9.0f));
+    g.drawText(label, row.removeFromLeft(28), juce::Justification::centredLeft);
+
+    auto bar = row.withSizeKeepingCentre(row.getWidth(), 8).toFloat();
+    g.setColour(juce::Colours::black.withAlpha(0.5f));
+    g.fillRect(bar);
+
+    g.setColour(colour);
+    g.fillRect(bar.withWidth(bar.getWidth() * juce::jlimit(0.0f, 1.0f, fillProportion)));
+
+    // Peak tick
+    if (peakProportion > 0.0f)
+    {
+        g.setColour(juce::Colours::white);
+        g.fillRect(bar.getX() + bar.getWidth() * juce::jmin(1.0f, peakProportion) - 1.0f, bar.getY(), 2.0f, bar.getHeight());
+    }
+}
+
+DM2DelayAudioProcessorEditor::ProfilerOverlay::ProfilerOverlay(Profiler& profilerToShow)
+    : profiler(profilerToShow)
+{
+    setInterceptsMouseClicks(false, true);
+
+    resetButton.setButtonText("Reset");
+    resetButton.onClick = [this]()
+    {
+        profiler.reset();
+        status = {};
+        framesUntilRefresh = 0;
+    };
+    addAndMakeVisible(resetButton);
+
+    saveButton.setButtonText("Save CSV");
+    saveButton.onClick = [this]() { saveCsv(); };
+    addAndMakeVisible(saveButton);
+}
+
+void DM2DelayAudioProcessorEditor::ProfilerOverlay::update()
+{
+    // Records are drained every frame so the FIFO never fills at small block sizes
+    profiler.collect();
+
+    if (--framesUntilRefresh > 0)
+        return;
+
+    framesUntilRefresh = framesPerRefresh;
+    summary = profiler.getSummary();
+    repaint();
+}
+
+void DM2DelayAudioProcessorEditor::ProfilerOverlay::saveCsv()
+{
+    const auto file = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+                          .getNonexistentChildFile("DM2Delay profile", ".csv");
+
+    status = profiler.writeCsv(file) ? "Saved " + file.getFileName()
+                                     : "Could not write " + file.getFullPathName();
+    repaint();
+}
+
+void DM2DelayAudioProcessorEditor::ProfilerOverlay::resized()
+{
+    auto buttons = getLocalBounds().reduced(8).removeFromBottom(22);
+    saveButton.setBounds(buttons.removeFromRight(80));
+    buttons.removeFromRight(6);
+    resetButton.setBounds(buttons.removeFromRight(60));
+}
+
+void DM2DelayAudioProcessorEditor::ProfilerOverlay::paint(juce::Graphics& g)
+{
+    g.setColour(juce::Colours::black.withAlpha(0.85f));
+    g.fillRoundedRectangle(getLocalBounds().toFloat(), 6.0f);
+
+    auto area = getLocalBounds().reduced(8);
+    const int lineHeight = 15;
+    auto percent = [](double load) { return juce::String(load * 100.0, 1) + "%"; };
+
+    g.setFont(juce::Font(12.0f, juce::Font::bold));
+    g.setColour(juce::Colours::white);
+    g.drawText("PROFILER", area.removeFromTop(lineHeight), juce::Justification::centredLeft);
+
+    g.setFont(juce::Font(11.0f));
+    g.setColour(summary.deadlineMisses > 0 ? juce::Colour(0xffff6060) : juce::Colours::white.withAlpha(0.85f));
+    g.drawText("blocks " + juce::String(summary.numBlocks)
+                   + "   deadline misses " + juce::String(summary.deadlineMisses)
+                   + "   xruns " + juce::String(summary.xruns),
+               area.removeFromTop(lineHeight), juce::Justification::centredLeft);
+
+    g.setColour(juce::Colours::white.withAlpha(0.85f));
+    g.drawText("load  avg " + percent(summary.averageLoad)
+                   + "   p50 " + percent(summary.medianLoad)
+                   + "   p99 " + percent(summary.p99Load)
+                   + "   max " + percent(summary.maxLoad),
+               area.removeFromTop(lineHeight), juce::Justification::centredLeft);
+
+    g.drawText("cycles per sample  " + juce::String(juce::roundToInt(summary.totalCyclesPerSample)),
+               area.removeFromTop(lineHeight), juce::Justification::centredLeft);
+
+    // Section table: one row per stage, one column per section
+    static const char* const sectionHeadings[] = { "comp", "delay", "bbd", "exp", "filter", "mix" };
+    const int labelWidth = 40;
+    const int cellWidth = (area.getWidth() - labelWidth) / Profiler::numSections;
+
+    area.removeFromTop(4);
+    auto headings = area.removeFromTop(lineHeight);
+    headings.removeFromLeft(labelWidth);
+    g.setColour(juce::Colours::white.withAlpha(0.6f));
+
+    for (const auto* heading : sectionHeadings)
+        g.drawText(heading, headings.removeFromLeft(cellWidth), juce::Justification::centredRight);
+
+    g.setColour(juce::Colours::white.withAlpha(0.85f));
+
+    for (int stage = 0; stage < Parameters::numStages; ++stage)
+    {
+        auto row = area.removeFromTop(lineHeight);
+        g.drawText("S" + juce::String(stage + 1), row.removeFromLeft(labelWidth), juce::Justification::centredLeft);
+
+        for (int section = 0; section < Profiler::numSections; ++section)
+        {
+            const auto cycles = summary.cyclesPerSample[static_cast<size_t>(stage * Profiler::numSections + section)];
+            g.drawText(juce::String(juce::roundToInt(cycles)), row.removeFromLeft(cellWidth), juce::Justification::centredRight);
+        }
+    }
+
+    auto clipRow = area.removeFromTop(lineHeight);
+    g.drawText("clip", clipRow.removeFromLeft(labelWidth), juce::Justification::centredLeft);
+    g.drawText(juce::String(juce::roundToInt(summary.cyclesPerSample[Profiler::outputClipColumn])),
+               clipRow.removeFromLeft(cellWidth), juce::Justification::centredRight);
+
+    if (status.isNotEmpty())
+    {
+        g.setColour(juce::Colours::white.withAlpha(0.6f));
+        g.drawText(status, area.removeFromTop(lineHeight), juce::Justification::centredLeft, true);
+    }
+}
+
+void DM2DelayAudioProcessorEditor::updateSizeForMode()
+{
+    // Custom mode shows two pedals side by side with cable connection, Standard mode a single pedal.
+    // Either way the window keeps its current scale and may be resized from 75% to 200%.
+    const int designWidth = getDesignWidth();
+    const float scale = uiScale; // the limits below may resize (and rescale) on their way
+
+    if (auto* constrainer = getConstrainer())
+        constrainer->setFixedAspectRatio(static_cast<double>(designWidth) / pedalHeight);
+
+    setResizeLimits(designWidth * 3 / 4, pedalHeight * 3 / 4, designWidth * 2, pedalHeight * 2);
+    setSize(juce::roundToInt(static_cast<float>(designWidth) * scale),
+            juce::roundToInt(static_cast<float>(pedalHeight) * scale));
     resized();
 }
 
@@ -321,9 +632,6 @@ void DM2DelayAudioProcessorEditor::drawPedalInstance(juce::Graphics& g, int xOff
     g.setColour(juce::Colours::white.withAlpha(0.1f));
     g.fillRect(xOffset + 10, 10, 380, 40);
     
-    // === LED INDICATOR (top center) ===
-    drawLED(g, xOffset + 200, 35, !isBypassed);
-    
     // === TITLE TEXT ===
     g.setColour(juce::Colours::white);
     g.setFont(juce::Font(22.0f, juce::Font::bold));
@@ -385,9 +693,6 @@ void DM2DelayAudioProcessorEditor::drawPedalInstance(juce::Graphics& g, int xOff
         }
     }
     
-    // Footswitch at bottom
-    drawFootswitch(g, juce::Rectangle<int>(xOffset, 380, 400, 100), isBypassed);
-    
     // Bottom text
     g.setColour(juce::Colours::white);
     g.setFont(juce::Font(8.0f));
@@ -397,7 +702,27 @@ void DM2DelayAudioProcessorEditor::drawPedalInstance(juce::Graphics& g, int xOff
         g.drawText("Made with JUCE", xOffset + 150, 505, 100, 15, juce::Justification::centred);
 }
 
+void DM2DelayAudioProcessorEditor::drawBypassIndicators(juce::Graphics& g, int xOffset)
+{
+    // LED (top center) and footswitch (bottom), the parts that change on bypass
+    drawLED(g, xOffset + 200, 35, !isBypassed);
+    drawFootswitch(g, juce::Rectangle<int>(xOffset, 380, 400, 100), isBypassed);
+}
+
 void DM2DelayAudioProcessorEditor::paint(juce::Graphics& g)
+{
+    g.addTransform(juce::AffineTransform::scale(uiScale));
+
+    // Static artwork at the screen's pixel density (window scale times display scale)
+    const float pixelScale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    g.drawImage(getArtwork(pixelScale),
+                juce::Rectangle<float>(0.0f, 0.0f, static_cast<float>(getDesignWidth()), static_cast<float>(pedalHeight)));
+
+    for (int xOffset = 0; xOffset < getDesignWidth(); xOffset += pedalWidth)
+        drawBypassIndicators(g, xOffset);
+}
+
+void DM2DelayAudioProcessorEditor::drawArtwork(juce::Graphics& g)
 {
     // Background
     g.fillAll(juce::Colour(0xff1a1a1a));
@@ -429,6 +754,14 @@ void DM2DelayAudioProcessorEditor::paint(juce::Graphics& g)
 
 void DM2DelayAudioProcessorEditor::resized()
 {
+    // The window is the design size times uiScale; the children are laid out in design
+    // coordinates below and scaled by their transform, text and all
+    uiScale = static_cast<float>(getHeight()) / static_cast<float>(pedalHeight);
+
+    const auto transform = juce::AffineTransform::scale(uiScale);
+    for (auto* child : getChildren())
+        child->setTransform(transform);
+
     // Main knobs (top row)
     int knobSize = 85;
     int knobY = 150;
@@ -436,7 +769,6 @@ void DM2DelayAudioProcessorEditor::resized()
     
     // In custom mode, position knobs on first pedal (left side)
     // In standard mode, center them in the single pedal
-    int pedalWidth = 400;
     int startX = (pedalWidth - (knobSpacing * 2 + knobSize)) / 2;
 
     delayTimeKnob.setBounds(startX, knobY, knobSize, knobSize);
@@ -451,7 +783,7 @@ void DM2DelayAudioProcessorEditor::resized()
     modulationKnob.setBounds(35, trimY + 55, trimSize, trimSize);
 
     // Stage 2 controls (second pedal - same positions but offset by 400px horizontally)
-    int stage2Offset = 400;
+    int stage2Offset = pedalWidth;
     delayTime2Knob.setBounds(stage2Offset + startX, knobY, knobSize, knobSize);
     feedback2Knob.setBounds(stage2Offset + startX + knobSpacing, knobY, knobSize, knobSize);
     mix2Knob.setBounds(stage2Offset + startX + knobSpacing * 2, knobY, knobSize, knobSize);
@@ -476,4 +808,10 @@ void DM2DelayAudioProcessorEditor::resized()
     
     customModeButton.setBounds(200, 245, 70, 30);
     customModeButton.setAlpha(0.0f);
+
+    // Meters - on first pedal, right of the internal trims
+    meterPanel.setBounds(250, 305, 125, 60);
+
+    // Profiler overlay - over the top of the first pedal
+    profilerOverlay.setBounds(10, 10, 380, 200);
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
 #include "PluginProcessor.h"
 
 /**
@@ -8,8 +9,19 @@
  * Vintage delay pedal interface inspired by classic analog designs
  * External: Delay Time, Feedback, Mix (main user controls)
  * Internal: Tone, Modulation (trim pots for fine-tuning)
+ * Meters: input level, compander gain reduction and wet level, polled from
+ * the processor at a fixed frame rate
+ *
+ * Everything is laid out and drawn in design coordinates (400x520 per pedal)
+ * and scaled to the window, which the user can resize. The static artwork is
+ * rasterized once per mode at the pixel scale it is shown at; a repaint blits
+ * it and redraws only the LEDs and footswitches on top.
+ *
+ * Cmd/Ctrl+Shift+P toggles a hidden profiler overlay (callback load and
+ * per-stage cycle counts, with CSV export) for diagnosing dropouts.
  */
-class DM2DelayAudioProcessorEditor : public juce::AudioProcessorEditor
+class DM2DelayAudioProcessorEditor : public juce::AudioProcessorEditor,
+                                     private juce::Timer
 {
 public:
     DM2DelayAudioProcessorEditor(DM2DelayAudioProcessor&);
@@ -17,6 +29,7 @@ public:
 
     void paint(juce::Graphics&) override;
     void resized() override;
+    bool keyPressed(const juce::KeyPress& key) override;
 
     // Get current mode state
     bool isInCustomMode() const { return isCustomMode; }
@@ -25,11 +38,96 @@ public:
     void updateSizeForMode();
 
 private:
+    /**
+     * Input, gain reduction and wet level meters
+     * An opaque child, so a meter update repaints this strip and nothing behind it
+     */
+    class MeterPanel : public juce::Component
+    {
+    public:
+        MeterPanel();
+
+        /** Show one reading, with fall-off; repaints only when the display moves */
+        void update(const Meters::Reading& reading);
+
+        void paint(juce::Graphics&) override;
+
+    private:
+        // Displayed values in dB (levels from floorDb up to 0, gain reduction from 0 up to maxGainReductionDb)
+        float inputRmsDb;
+        float inputPeakDb;
+        float wetRmsDb;
+        float wetPeakDb;
+        float gainReductionDb;
+
+        static constexpr float floorDb = -60.0f;
+        static constexpr float maxGainReductionDb = 20.0f;
+
+        // How far the display may fall per frame (about 45 dB/s at 30 frames per second)
+        static constexpr float fallDbPerFrame = 1.5f;
+
+        /** One labelled bar: fill up to the given proportion, with an optional peak tick */
+        void drawMeter(juce::Graphics& g, juce::Rectangle<int> row, const juce::String& label,
+                       float fillProportion, float peakProportion, juce::Colour colour);
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MeterPanel)
+    };
+
+    /**
+     * Profiler read-out: callback load, deadline misses and cycles per sample
+     * for each stage section, with buttons to start afresh and to save a CSV
+     * Clicks outside the buttons fall through to the controls underneath
+     */
+    class ProfilerOverlay : public juce::Component
+    {
+    public:
+        explicit ProfilerOverlay(Profiler& profilerToShow);
+
+        /** Drain the profiler's records every frame, and refresh the text a few times a second */
+        void update();
+
+        void paint(juce::Graphics&) override;
+        void resized() override;
+
+    private:
+        Profiler& profiler;
+        Profiler::Summary summary;
+        juce::String status;
+
+        juce::TextButton resetButton;
+        juce::TextButton saveButton;
+
+        static constexpr int framesPerRefresh = 10;
+        int framesUntilRefresh = 0;
+
+        /** Write a CSV into the user's documents folder, and say where */
+        void saveCsv();
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProfilerOverlay)
+    };
+
     DM2DelayAudioProcessor& audioProcessor;
 
+    // Design size of one pedal; the window is this (or two of it) times uiScale
+    static constexpr int pedalWidth = 400;
+    static constexpr int pedalHeight = 520;
+    float uiScale = 1.0f;
+
+    // Static artwork for Standard [0] and Custom [1] mode, and the pixel scale each was rendered at
+    std::array<juce::Image, 2> artwork;
+    std::array<float, 2> artworkPixelScale{};
+
+    // Meters are polled (never pushed) so the audio thread does no GUI work
+    static constexpr int meterFrameRate = 30;
+    MeterPanel meterPanel;
+
+    // Hidden unless toggled; profiling runs exactly while it is shown
+    ProfilerOverlay profilerOverlay;
+
     // Bypass and mode state
     bool isBypassed = false;
     bool isCustomMode = false; // false = Standard, true = Custom (cascaded)
+    bool isLongDelay = false;  // delay knobs on the long (2 s) parameters rather than the pedal's 300 ms
 
     // Stage 1 controls (first pedal)
     juce::Slider delayTimeKnob;
@@ -80,12 +178,35 @@ private:
     juce::TextButton standardModeButton;
     juce::TextButton customModeButton;
 
+    /** Poll the meters, and pick up bypass, mode and delay range changes made by the host or a preset */
+    void timerCallback() override;
+
+    /** Attach the delay time knobs to the parameters of the selected delay range */
+    void attachDelayTimeKnobs();
+
+    /** Show or hide the profiler overlay, switching the processor's profiling with it */
+    void setProfilerVisible(bool shouldBeVisible);
+
+    /** Repaint the LEDs and footswitches of the visible pedals */
+    void repaintBypassIndicators();
+
+    /** Repaint an area given in design coordinates */
+    void repaintDesignArea(juce::Rectangle<int> area);
+
+    /** Width of the current mode's layout in design coordinates */
+    int getDesignWidth() const { return isCustomMode ? pedalWidth * 2 : pedalWidth; }
+
+    /** The current mode's static artwork, re-rendered only when the pixel scale changes */
+    const juce::Image& getArtwork(float pixelScale);
+
     // Helper methods
     void drawInputJack(juce::Graphics& g, int x, int y);
     void drawOutputJack(juce::Graphics& g, int x, int y);
     void drawLED(juce::Graphics& g, int x, int y, bool isOn);
     void drawFootswitch(juce::Graphics& g, juce::Rectangle<int> area, bool isPressed);
     void drawPedalInstance(juce::Graphics& g, int xOffset, bool isSecondInstance);
+    void drawBypassIndicators(juce::Graphics& g, int xOffset);
+    void drawArtwork(juce::Graphics& g);
     void drawSignalCable(juce::Graphics& g, int x1, int y1, int x2, int y2);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DM2DelayAudioProcessorEditor)
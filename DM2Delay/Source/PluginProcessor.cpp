@@ -5,12 +5,17 @@ DM2DelayAudioProcessor::DM2DelayAudioProcessor()
     : AudioProcessor(BusesProperties()
                          .withInput("Input", juce::AudioChannelSet::stereo(), true)
                          .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
-      apvts(*this, nullptr, "Parameters", Parameters::createParameterLayout())
+      apvts(*this, nullptr, "Parameters", Parameters::createParameterLayout()),
+      parameterHandles(apvts),
+      presetBank(apvts)
 {
+    startTimerHz(10);
 }
 
 DM2DelayAudioProcessor::~DM2DelayAudioProcessor()
 {
+    stopTimer();
+    helperThread.stop();
 }
 
 const juce::String DM2DelayAudioProcessor::getName() const
@@ -35,101 +40,245 @@ bool DM2DelayAudioProcessor::isMidiEffect() const
 
 double DM2DelayAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return StageGraph<SIMDSample>::getTailSeconds(readStagePatch(ParameterSnapshot::capture(parameterHandles, getSampleRate())));
+}
+
+DM2DelayAudioProcessor::StagePatch DM2DelayAudioProcessor::readStagePatch(const ParameterSnapshot& parameters) const
+{
+    StagePatch patch;
+    patch.numStages = Parameters::numStages;
+    patch.routing = parameters.parallelRouting ? StageGraph<SIMDSample>::Routing::parallel
+                                               : StageGraph<SIMDSample>::Routing::series;
+    patch.idleNoiseFloor = keepIdleNoiseFloor.load();
+
+    for (size_t stage = 0; stage < parameters.stages.size(); ++stage)
+    {
+        const auto& values = parameters.stages[stage];
+        auto& settings = patch.stages[stage];
+
+        // Stage 2 only runs in custom mode; the engine (digital ring buffer or
+        // clocked bucket brigade) is shared
+        settings.enabled = stage == 0 || parameters.customMode;
+        settings.clockedEngine = parameters.clockedEngine;
+        settings.delayTime = values.delayTimeMs;
+        settings.delaySamples = values.delaySamples;
+        settings.feedbackGain = values.feedbackGain;
+        settings.modulation = values.modulationHz;
+        settings.tone = values.tone;
+        settings.mixLevel = values.mixLevel;
+    }
+
+    return patch;
 }
 
 int DM2DelayAudioProcessor::getNumPrograms()
 {
-    return 1;
+    return presetBank.getNumPresets();
 }
 
 int DM2DelayAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram.load();
 }
 
 void DM2DelayAudioProcessor::setCurrentProgram(int index)
 {
-    juce::ignoreUnused(index);
+    if (! juce::isPositiveAndBelow(index, presetBank.getNumPresets()))
+        return;
+
+    // Hosts call this from any thread, so only hand the pre-built snapshot over:
+    // the audio thread stores it before its next block, the timer tells the host
+    currentProgram.store(index);
+
+    const auto* preset = &presetBank.getSnapshot(index);
+    pendingPreset.store(preset, std::memory_order_release);
+    unpublishedPreset.store(preset, std::memory_order_release);
 }
 
 const juce::String DM2DelayAudioProcessor::getProgramName(int index)
 {
-    juce::ignoreUnused(index);
-    return {};
+    return presetBank.getName(index);
 }
 
 void DM2DelayAudioProcessor::changeProgramName(int index, const juce::String& newName)
 {
+    // Factory presets keep their names
     juce::ignoreUnused(index, newName);
 }
 
 void DM2DelayAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    // Initialize Stage 1 DSP modules for both channels
-    delayLineLeft.prepare(sampleRate, samplesPerBlock);
-    delayLineRight.prepare(sampleRate, samplesPerBlock);
-    
-    companderLeft.prepare(sampleRate);
-    companderRight.prepare(sampleRate);
-    
-    bbdModelLeft.prepare(sampleRate);
-    bbdModelRight.prepare(sampleRate);
-    
-    filterLeft.prepare(sampleRate);
-    filterRight.prepare(sampleRate);
-    
-    mixStageLeft.prepare(sampleRate);
-    mixStageRight.prepare(sampleRate);
-
-    // Initialize Stage 2 DSP modules for cascaded mode
-    delayLine2Left.prepare(sampleRate, samplesPerBlock);
-    delayLine2Right.prepare(sampleRate, samplesPerBlock);
-    
-    compander2Left.prepare(sampleRate);
-    compander2Right.prepare(sampleRate);
-    
-    bbdModel2Left.prepare(sampleRate);
-    bbdModel2Right.prepare(sampleRate);
-    
-    filter2Left.prepare(sampleRate);
-    filter2Right.prepare(sampleRate);
-    
-    mixStage2Left.prepare(sampleRate);
-    mixStage2Right.prepare(sampleRate);
+    // One group per SIMD register's worth of channels, for whatever layout the host chose
+    const int numChannels = juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels());
+    const int requiredGroups = juce::jmax(1, (numChannels + channelsPerGroup - 1) / channelsPerGroup);
+
+    if (requiredGroups != numChannelGroups)
+    {
+        channelGroups.reset(new ChannelGroup[static_cast<size_t>(requiredGroups)]);
+        numChannelGroups = requiredGroups;
+    }
+
+    // Initialize every stage for every channel group
+    for (int group = 0; group < numChannelGroups; ++group)
+    {
+        channelGroups[group].stages.prepare(sampleRate, samplesPerBlock, Parameters::numStages,
+                                            Parameters::delayTimeLongMax, useCompactDelayStorage);
+        channelGroups[group].stages.setProfiling(stagesProfiling);
+        channelGroups[group].outputClipper.prepare(samplesPerBlock);
+        channelGroups[group].outputClipCycles = 0;
+        channelGroups[group].frames.assign(static_cast<size_t>(juce::jmax(1, samplesPerBlock)),
+                                           LaneOps::broadcast<SIMDSample>(0.0f));
+
+        // Distinct seed per stage and group so no two noise streams coincide
+        if (useFixedNoiseSeed)
+            channelGroups[group].stages.setNoiseSeed(noiseSeed + static_cast<juce::uint32>(group * Parameters::numStages));
+    }
+
+    const auto scratchSize = static_cast<size_t>(juce::jmax(1, samplesPerBlock));
+    maxChunkSize = static_cast<int>(scratchSize);
+
+    profiler.prepare(sampleRate, samplesPerBlock);
+
+    // Only worth a thread when there are groups to share and a core to share them with
+    if (useHelperThread && numChannelGroups > 1 && juce::SystemStats::getNumCpus() > 1)
+        helperThread.start();
+    else
+        helperThread.stop();
+
+    // Bypass: crossfade gains, the dry signal, and a delay long enough for the largest latency
+    Oversampler<float> latencyProbe;
+    latencyProbe.setFactorLog2(Oversampler<float>::maxFactorLog2);
+
+    bypassEffectGains.assign(scratchSize, 0.0f);
+    bypassDryGains.assign(scratchSize, 0.0f);
+    bypassDryBuffer.setSize(numChannels, static_cast<int>(scratchSize));
+    bypassDelayRing.setSize(numChannels, juce::jmax(1, latencyProbe.getLatencyInSamples()));
+    bypassDelayRing.clear();
+    bypassDelayIndex = 0;
+
+    // Not on the audio thread here, so the latency can be reported directly
+    applyOversampling(static_cast<int>(parameterHandles.oversampling->load()));
+    setLatencySamples(oversamplingLatency.load());
+}
+
+void DM2DelayAudioProcessor::applyOversampling(int factorLog2)
+{
+    oversamplingFactorLog2 = factorLog2;
+
+    for (int group = 0; group < numChannelGroups; ++group)
+    {
+        channelGroups[group].stages.setOversamplingFactorLog2(factorLog2);
+        channelGroups[group].outputClipper.setFactorLog2(factorLog2);
+    }
+
+    // The BBD saturation latency is absorbed by the delay time; only the output clip is reported
+    if (numChannelGroups > 0)
+        oversamplingLatency.store(channelGroups[0].outputClipper.getLatencyInSamples());
+
+    // The bypassed signal must line up with the processed one
+    bypassDelayLength = juce::jmin(oversamplingLatency.load(), bypassDelayRing.getNumSamples());
+    bypassDelayIndex = 0;
+    bypassDelayRing.clear();
+}
+
+juce::AudioProcessorParameter* DM2DelayAudioProcessor::getBypassParameter() const
+{
+    return apvts.getParameter(Parameters::bypassID);
+}
+
+void DM2DelayAudioProcessor::setBypass(bool shouldBypass)
+{
+    if (auto* parameter = apvts.getParameter(Parameters::bypassID))
+        parameter->setValueNotifyingHost(shouldBypass ? 1.0f : 0.0f);
+}
+
+void DM2DelayAudioProcessor::delayBypassedSignal(juce::AudioBuffer<float>& signal, int start, int numSamples)
+{
+    if (bypassDelayLength == 0)
+        return;
+
+    const int numChannels = juce::jmin(signal.getNumChannels(), bypassDelayRing.getNumChannels());
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* data = signal.getWritePointer(channel, start);
+        auto* ring = bypassDelayRing.getWritePointer(channel);
+        int index = bypassDelayIndex;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            std::swap(data[i], ring[index]);
+            index = index + 1 < bypassDelayLength ? index + 1 : 0;
+        }
+    }
+
+    bypassDelayIndex = (bypassDelayIndex + numSamples) % bypassDelayLength;
+}
+
+void DM2DelayAudioProcessor::primeBypassDelay(const juce::AudioBuffer<float>& signal, int start, int numSamples)
+{
+    if (bypassDelayLength == 0)
+        return;
+
+    // Only the newest bypassDelayLength samples can ever come out of the ring
+    const int first = juce::jmax(0, numSamples - bypassDelayLength);
+    const int numChannels = juce::jmin(signal.getNumChannels(), bypassDelayRing.getNumChannels());
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto* data = signal.getReadPointer(channel, start);
+        auto* ring = bypassDelayRing.getWritePointer(channel);
+        int index = bypassDelayIndex;
+
+        for (int i = first; i < numSamples; ++i)
+        {
+            ring[index] = data[i];
+            index = index + 1 < bypassDelayLength ? index + 1 : 0;
+        }
+    }
+
+    bypassDelayIndex = (bypassDelayIndex + numSamples - first) % bypassDelayLength;
+}
+
+void DM2DelayAudioProcessor::timerCallback()
+{
+    const int latency = oversamplingLatency.load();
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+
+    if (const auto* preset = unpublishedPreset.exchange(nullptr, std::memory_order_acquire))
+    {
+        preset->publish();
+
+        // The parameter objects hold the preset now; if the audio thread has not
+        // stored it yet, it must not later overwrite edits made after this point
+        auto expected = preset;
+        pendingPreset.compare_exchange_strong(expected, nullptr);
+
+        updateHostDisplay(juce::AudioProcessor::ChangeDetails().withProgramChanged(true));
+    }
+}
+
+void DM2DelayAudioProcessor::setNoiseSeed(juce::uint32 seed)
+{
+    useFixedNoiseSeed = true;
+    noiseSeed = seed;
 }
 
 void DM2DelayAudioProcessor::releaseResources()
 {
-    // Reset Stage 1 DSP modules
-    delayLineLeft.reset();
-    delayLineRight.reset();
-    companderLeft.reset();
-    companderRight.reset();
-    bbdModelLeft.reset();
-    bbdModelRight.reset();
-    filterLeft.reset();
-    filterRight.reset();
-    mixStageLeft.reset();
-    mixStageRight.reset();
-
-    // Reset Stage 2 DSP modules
-    delayLine2Left.reset();
-    delayLine2Right.reset();
-    compander2Left.reset();
-    compander2Right.reset();
-    bbdModel2Left.reset();
-    bbdModel2Right.reset();
-    filter2Left.reset();
-    filter2Right.reset();
-    mixStage2Left.reset();
-    mixStage2Right.reset();
+    // Reset every stage
+    for (int group = 0; group < numChannelGroups; ++group)
+        channelGroups[group].stages.reset();
+
+    // Nothing for the helper to do until playback resumes
+    helperThread.stop();
 }
 
 bool DM2DelayAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-        && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any layout works (mono, stereo, 5.1, 7.1, 7.1.4, ...): state is allocated per channel
+    if (layouts.getMainOutputChannelSet().isDisabled())
         return false;
 
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
@@ -142,7 +291,75 @@ void DM2DelayAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
                                            juce::MidiBuffer& midiMessages)
 {
     juce::ignoreUnused(midiMessages);
+    renderTimedBlock(buffer, getBypass());
+}
+
+void DM2DelayAudioProcessor::processBlockBypassed(juce::AudioBuffer<float>& buffer,
+                                                  juce::MidiBuffer& midiMessages)
+{
+    // The host's own bypass, for hosts that don't use the bypass parameter
+    juce::ignoreUnused(midiMessages);
+    renderTimedBlock(buffer, true);
+}
+
+void DM2DelayAudioProcessor::renderTimedBlock(juce::AudioBuffer<float>& buffer, bool bypassRequested)
+{
+    // Stages only switch section timing on or off between blocks
+    const bool profiling = profiler.isEnabled();
+
+    if (profiling != stagesProfiling)
+    {
+        for (int group = 0; group < numChannelGroups; ++group)
+            channelGroups[group].stages.setProfiling(profiling);
+
+        stagesProfiling = profiling;
+    }
+
+    if (! profiling)
+    {
+        renderBlock(buffer, bypassRequested);
+        return;
+    }
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    const auto startCycles = CycleCounter::now();
+
+    renderBlock(buffer, bypassRequested);
+
+    Profiler::Block block;
+    block.totalCycles = CycleCounter::now() - startCycles;
+    block.seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    block.numSamples = buffer.getNumSamples();
+
+    // One column per stage section, summed over the channel groups
+    for (int group = 0; group < numChannelGroups; ++group)
+    {
+        auto& channelGroup = channelGroups[group];
+
+        for (int stage = 0; stage < Parameters::numStages; ++stage)
+        {
+            BBDStage<SIMDSample>::SectionCycles sections{};
+            channelGroup.stages.collectSectionCycles(stage, sections);
+
+            for (int section = 0; section < Profiler::numSections; ++section)
+                block.cycles[static_cast<size_t>(stage * Profiler::numSections + section)] += sections[static_cast<size_t>(section)];
+        }
+
+        block.cycles[Profiler::outputClipColumn] += channelGroup.outputClipCycles;
+        channelGroup.outputClipCycles = 0;
+    }
+
+    profiler.publish(block);
+}
+
+void DM2DelayAudioProcessor::renderBlock(juce::AudioBuffer<float>& buffer, bool bypassRequested)
+{
     juce::ScopedNoDenormals noDenormals;
+    RealtimeGuard::ScopedAudioThread realtimeGuard;
+
+    // A program change lands before anything reads this block's parameters
+    if (const auto* preset = pendingPreset.exchange(nullptr, std::memory_order_acquire))
+        preset->store();
 
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -151,123 +368,213 @@ void DM2DelayAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    // Check bypass state - apply safety limiting even when bypassed
-    if (isBypassed.load())
+    // Every parameter this block needs, loaded once
+    const auto parameters = ParameterSnapshot::capture(parameterHandles, getSampleRate());
+
+    // With trails the repeats keep ringing out through bypass, fed with silence
+    const bool bypassTrails = parameters.trails;
+
+    // Stage settings and routing for this block
+    const StagePatch patch = readStagePatch(parameters);
+
+    const int numSamples = buffer.getNumSamples();
+
+    // Not prepared yet - nothing sensible to render into
+    if (maxChunkSize == 0)
+        return;
+
+    // Oversampling changes apply right away; the host hears about the new latency
+    // from the message thread (timerCallback)
+    if (parameters.oversamplingFactorLog2 != oversamplingFactorLog2)
+        applyOversampling(parameters.oversamplingFactorLog2);
+
+    // Fully bypassed: the input only waits out the latency the host compensates for
+    if (bypassRequested && bypassPosition >= 1.0f && ! bypassTrails)
     {
-        // Apply soft clipping to prevent digital clipping even in bypass
-        for (int channel = 0; channel < totalNumInputChannels; ++channel)
-        {
-            auto* channelData = buffer.getWritePointer(channel);
-            for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-            {
-                channelData[sample] = std::tanh(channelData[sample]);
-            }
-        }
+        delayBypassedSignal(buffer, 0, numSamples);
+        effectSuspended = true;
         return;
     }
 
-    // Get parameter values for Stage 1
-    float delayTime = apvts.getRawParameterValue(Parameters::delayTimeID)->load();
-    float feedback = apvts.getRawParameterValue(Parameters::feedbackID)->load();
-    float mix = apvts.getRawParameterValue(Parameters::mixID)->load();
-    float tone = apvts.getRawParameterValue(Parameters::toneID)->load();
-
-    // Check if in custom mode (cascaded delay)
-    bool isCustomMode = apvts.getRawParameterValue(Parameters::modeID)->load() > 0.5f;
-    
-    // Get stage 2 parameters if in custom mode
-    float delayTime2 = 0.0f;
-    float feedback2 = 0.0f;
-    float mix2 = 0.0f;
-    float tone2 = 0.0f;
-    
-    if (isCustomMode)
+    // Back from a full bypass: whatever the delay lines held is stale
+    if (effectSuspended)
     {
-        delayTime2 = apvts.getRawParameterValue(Parameters::delayTime2ID)->load();
-        feedback2 = apvts.getRawParameterValue(Parameters::feedback2ID)->load();
-        mix2 = apvts.getRawParameterValue(Parameters::mix2ID)->load();
-        tone2 = apvts.getRawParameterValue(Parameters::tone2ID)->load();
+        for (int group = 0; group < numChannelGroups; ++group)
+        {
+            channelGroups[group].stages.reset();
+            channelGroups[group].outputClipper.reset();
+        }
+
+        effectSuspended = false;
     }
 
-    // Process each channel
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
+    const float bypassTarget = bypassRequested ? 1.0f : 0.0f;
+    const float bypassFadeStep = static_cast<float>(1.0 / (bypassFadeSeconds * getSampleRate()));
+
+    // Only channels that were allocated in prepareToPlay can be processed
+    const int numChannels = juce::jmin(totalNumInputChannels, numChannelGroups * channelsPerGroup);
+
+    // Taken once here: fetching write pointers from the helper thread would race on the buffer
+    float* const* channelPointers = buffer.getArrayOfWritePointers();
+
+    for (int group = 0; group < numChannelGroups; ++group)
+        channelGroups[group].levels = Meters::Levels();
+
+    // Hosts may exceed the prepared block size, so walk the buffer in scratch-sized chunks
+    for (int start = 0; start < numSamples; start += maxChunkSize)
     {
-        auto* channelData = buffer.getWritePointer(channel);
-        
-        // Select DSP modules for Stage 1
-        DelayLine& delayLine = (channel == 0) ? delayLineLeft : delayLineRight;
-        Compander& compander = (channel == 0) ? companderLeft : companderRight;
-        BBDModel& bbdModel = (channel == 0) ? bbdModelLeft : bbdModelRight;
-        Filter& filter = (channel == 0) ? filterLeft : filterRight;
-        MixStage& mixStage = (channel == 0) ? mixStageLeft : mixStageRight;
-
-        // Select DSP modules for Stage 2 (if needed)
-        DelayLine& delayLine2 = (channel == 0) ? delayLine2Left : delayLine2Right;
-        Compander& compander2 = (channel == 0) ? compander2Left : compander2Right;
-        BBDModel& bbdModel2 = (channel == 0) ? bbdModel2Left : bbdModel2Right;
-        Filter& filter2 = (channel == 0) ? filter2Left : filter2Right;
-        MixStage& mixStage2 = (channel == 0) ? mixStage2Left : mixStage2Right;
-
-        // Process sample-by-sample
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+        const int chunkSize = juce::jmin(maxChunkSize, numSamples - start);
+
+        // While bypass is (or is becoming) active the dry signal is heard: keep a latency-aligned
+        // copy and equal-power gains for this chunk (the effect side is exactly 0 once bypassed)
+        const bool bypassing = bypassRequested || bypassPosition > 0.0f;
+
+        if (bypassing)
         {
-            float inputSample = channelData[sample];
-            float drySample = inputSample; // Save for mixing
-            
-            // STAGE 1 DSP Chain
-            // 1. Compressor (pre-BBD)
-            float compressed = compander.compress(inputSample);
-            
-            // 2. BBD Delay
-            float delayed = delayLine.processSample(compressed, delayTime, feedback);
-            
-            // 3. BBD artifacts
-            float bbdProcessed = bbdModel.processSample(delayed, delayTime);
-            
-            // 4. Expander (post-BBD)
-            float expanded = compander.expand(bbdProcessed);
-            
-            // 5. Filter stage
-            float filtered = filter.processSample(expanded, tone);
-            
-            // 6. Mix stage 1 output
-            float stage1Output = mixStage.processSample(drySample, filtered, mix);
-            
-            // STAGE 2: Cascaded processing (if in custom mode)
-            float finalOutput = stage1Output;
-            
-            if (isCustomMode)
+            for (int sample = 0; sample < chunkSize; ++sample)
             {
-                // Stage 2 processes the output of Stage 1 (true cascade)
-                float stage2Input = stage1Output;
-                
-                // 1. Stage 2 Compressor
-                float compressed2 = compander2.compress(stage2Input);
-                
-                // 2. Stage 2 BBD Delay  
-                float delayed2 = delayLine2.processSample(compressed2, delayTime2, feedback2);
-                
-                // 3. Stage 2 BBD artifacts
-                float bbdProcessed2 = bbdModel2.processSample(delayed2, delayTime2);
-                
-                // 4. Stage 2 Expander
-                float expanded2 = compander2.expand(bbdProcessed2);
-                
-                // 5. Stage 2 Filter
-                float filtered2 = filter2.processSample(expanded2, tone2);
-                
-                // 6. Mix stage 2: blend stage1 dry with stage 2 wet (not original input!)
-                finalOutput = mixStage2.processSample(stage2Input, filtered2, mix2);
+                bypassPosition = bypassTarget > bypassPosition ? juce::jmin(bypassTarget, bypassPosition + bypassFadeStep)
+                                                               : juce::jmax(bypassTarget, bypassPosition - bypassFadeStep);
+
+                const float angle = juce::MathConstants<float>::halfPi * bypassPosition;
+                bypassEffectGains[static_cast<size_t>(sample)] = bypassPosition >= 1.0f ? 0.0f : std::cos(angle);
+                bypassDryGains[static_cast<size_t>(sample)] = std::sin(angle);
             }
-            
-            // Soft clip to prevent digital clipping
-            finalOutput = std::tanh(finalOutput);
-            
-            channelData[sample] = finalOutput;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                bypassDryBuffer.copyFrom(channel, 0, buffer, channel, start, chunkSize);
+
+            delayBypassedSignal(bypassDryBuffer, 0, chunkSize);
+        }
+        else
+        {
+            primeBypassDelay(buffer, start, chunkSize);
+        }
+
+        ChunkContext chunk;
+        chunk.channels = channelPointers;
+        chunk.start = start;
+        chunk.numSamples = chunkSize;
+        chunk.numChannels = numChannels;
+        chunk.bypassing = bypassing;
+        chunk.bypassTrails = bypassTrails;
+        chunk.patch = &patch;
+
+        // Groups are independent, so with a large chunk the helper takes the upper half
+        const int numActiveGroups = (numChannels + channelsPerGroup - 1) / channelsPerGroup;
+
+        if (numActiveGroups > 1 && chunkSize >= helperMinChunkSize && helperThread.isRunning())
+        {
+            const int splitGroup = (numActiveGroups + 1) / 2;
+
+            helperChunk = chunk;
+            helperFirstGroup = splitGroup;
+            helperEndGroup = numActiveGroups;
+            helperThread.post(renderHelperGroups, this);
+
+            renderGroups(chunk, 0, splitGroup);
+            helperThread.join();
+        }
+        else
+        {
+            renderGroups(chunk, 0, numActiveGroups);
+        }
+
+        // Bypassed signal on top of whatever the effect still renders
+        if (bypassing)
+            for (int channel = 0; channel < numChannels; ++channel)
+                juce::FloatVectorOperations::addWithMultiply(buffer.getWritePointer(channel, start),
+                                                             bypassDryBuffer.getReadPointer(channel),
+                                                             bypassDryGains.data(), chunkSize);
+    }
+
+    // Every group has finished (the helper's included), so their levels can be combined
+    Meters::Levels blockLevels;
+    for (int group = 0; group < numChannelGroups; ++group)
+        blockLevels.add(channelGroups[group].levels);
+
+    meters.publish(blockLevels);
+}
+
+void DM2DelayAudioProcessor::renderGroups(const ChunkContext& chunk, int firstGroup, int endGroup)
+{
+    const int numSamples = chunk.numSamples;
+    const auto& patch = *chunk.patch;
+
+    for (int group = firstGroup; group < endGroup; ++group)
+    {
+        auto& channelGroup = channelGroups[group];
+        SIMDSample* frames = channelGroup.frames.data();
+        const int firstChannel = group * channelsPerGroup;
+        const int groupChannels = juce::jmin(channelsPerGroup, chunk.numChannels - firstChannel);
+
+        // Interleave: one channel per lane (spare lanes just carry silence)
+        std::fill(frames, frames + numSamples, LaneOps::broadcast<SIMDSample>(0.0f));
+        for (int lane = 0; lane < groupChannels; ++lane)
+        {
+            const float* channelData = chunk.channels[firstChannel + lane] + chunk.start;
+            for (int sample = 0; sample < numSamples; ++sample)
+                frames[sample].set(static_cast<size_t>(lane), channelData[sample]);
         }
+
+        // Input level for the meters, before any bypass fade
+        Meters::Levels chunkLevels;
+        chunkLevels.inputPeak = LaneOps::getPeakLevel(frames, numSamples);
+        chunkLevels.inputSumOfSquares = LaneOps::getSumOfSquares(frames, numSamples);
+        chunkLevels.numChannelSamples = numSamples * groupChannels;
+
+        // With trails the input fades out of (and back into) the effect, so the delay lines
+        // never start or stop on a step while the repeats ring on. Without trails only the
+        // output fades below: fading both would apply the gain twice to one path
+        if (chunk.bypassing && chunk.bypassTrails)
+            for (int sample = 0; sample < numSamples; ++sample)
+                frames[sample] *= bypassEffectGains[static_cast<size_t>(sample)];
+
+        // Each stage renders the whole chunk through each of its modules in turn;
+        // in series (custom mode's cascade) stage 2 blends against the stage 1
+        // output as its dry signal, not the original input. A stage whose repeats
+        // have died away on silent input idles inside the graph (see StageGraph)
+        channelGroup.stages.process(frames, numSamples, patch);
+
+        const auto& stageLevels = channelGroup.stages.getLevels();
+        chunkLevels.wetPeak = stageLevels.wetPeak;
+        chunkLevels.wetSumOfSquares = stageLevels.wetSumOfSquares;
+        chunkLevels.compressionGain = stageLevels.compressionGain;
+
+        // Soft clip to prevent digital clipping, oversampled to keep it alias-free
+        const auto clipStart = stagesProfiling ? CycleCounter::now() : 0;
+
+        SIMDSample* upsampled = channelGroup.outputClipper.processSamplesUp(frames, numSamples);
+        SoftClip::tanhBlock(upsampled, numSamples * channelGroup.outputClipper.getFactor());
+        channelGroup.outputClipper.processSamplesDown(frames, numSamples);
+
+        if (stagesProfiling)
+            channelGroup.outputClipCycles += CycleCounter::now() - clipStart;
+
+        // Without trails the whole effect output (its dry blend included) crossfades
+        // against the bypassed signal: cos here, sin there, equal power
+        if (chunk.bypassing && ! chunk.bypassTrails)
+            for (int sample = 0; sample < numSamples; ++sample)
+                frames[sample] *= bypassEffectGains[static_cast<size_t>(sample)];
+
+        // De-interleave
+        for (int lane = 0; lane < groupChannels; ++lane)
+        {
+            float* channelData = chunk.channels[firstChannel + lane] + chunk.start;
+            for (int sample = 0; sample < numSamples; ++sample)
+                channelData[sample] = frames[sample].get(static_cast<size_t>(lane));
+        }
+
+        channelGroup.levels.add(chunkLevels);
     }
 }
 
+void DM2DelayAudioProcessor::renderHelperGroups(void* processor)
+{
+    auto& self = *static_cast<DM2DelayAudioProcessor*>(processor);
+    self.renderGroups(self.helperChunk, self.helperFirstGroup, self.helperEndGroup);
+}
+
 bool DM2DelayAudioProcessor::hasEditor() const
 {
     return true;
@@ -280,6 +587,12 @@ juce::AudioProcessorEditor* DM2DelayAudioProcessor::createEditor()
 
 void DM2DelayAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
+    if (stateFormat == StateFormat::binary)
+    {
+        writeBinaryState(destData);
+        return;
+    }
+
     auto state = apvts.copyState();
     std::unique_ptr<juce::XmlElement> xml(state.createXml());
     copyXmlToBinary(*xml, destData);
@@ -287,6 +600,14 @@ void DM2DelayAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 
 void DM2DelayAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    // The restored state wins over a preset recall that has not landed yet
+    pendingPreset.store(nullptr);
+    unpublishedPreset.store(nullptr);
+
+    if (readBinaryState(data, sizeInBytes))
+        return;
+
+    // Sessions saved as XML (and by earlier versions)
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
 
     if (xmlState.get() != nullptr)
@@ -294,6 +615,94 @@ void DM2DelayAudioProcessor::setStateInformation(const void* data, int sizeInByt
             apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
 }
 
+void DM2DelayAudioProcessor::writeBinaryState(juce::MemoryBlock& destData) const
+{
+    juce::Array<juce::RangedAudioParameter*> parameters;
+    for (auto* parameter : getParameters())
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            parameters.add(ranged);
+
+    juce::MemoryOutputStream stream(destData, false);
+    stream.writeInt(binaryStateMagic);
+    stream.writeInt(binaryStateVersion);
+    stream.writeInt(currentProgram.load());
+    stream.writeInt(parameters.size());
+
+    // Plain values keyed by ID, so states survive parameters being added, removed or re-ranged
+    for (auto* parameter : parameters)
+    {
+        stream.writeString(parameter->paramID);
+        stream.writeFloat(parameter->convertFrom0to1(parameter->getValue()));
+    }
+}
+
+bool DM2DelayAudioProcessor::readBinaryState(const void* data, int sizeInBytes)
+{
+    const int headerSize = 4 * static_cast<int>(sizeof(juce::int32));
+    if (data == nullptr || sizeInBytes < headerSize)
+        return false;
+
+    juce::MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
+    if (stream.readInt() != binaryStateMagic)
+        return false;
+
+    // Ours, but from a newer build: leave the current state alone rather than guess
+    const int version = stream.readInt();
+    if (version < 1 || version > binaryStateVersion)
+    {
+        jassertfalse;
+        return true;
+    }
+
+    const int program = stream.readInt();
+    const int numRecords = stream.readInt();
+
+    std::vector<std::pair<juce::String, float>> records;
+    for (int i = 0; i < numRecords && ! stream.isExhausted(); ++i)
+    {
+        auto parameterID = stream.readString();
+        const float value = stream.readFloat();
+        records.emplace_back(std::move(parameterID), value);
+    }
+
+    // Restored through the parameter tree, as an XML state is, so the host sees no automation
+    // writes; parameters the state doesn't mention (added since it was saved) go back to their defaults
+    auto state = apvts.copyState();
+    for (auto* parameter : getParameters())
+    {
+        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+        if (ranged == nullptr)
+            continue;
+
+        float normalisedValue = ranged->getDefaultValue();
+        for (const auto& record : records)
+        {
+            if (record.first == ranged->paramID)
+            {
+                normalisedValue = ranged->convertTo0to1(record.second);
+                break;
+            }
+        }
+
+        auto parameterState = state.getChildWithProperty("id", ranged->paramID);
+        if (! parameterState.isValid())
+        {
+            parameterState = juce::ValueTree("PARAM");
+            parameterState.setProperty("id", ranged->paramID, nullptr);
+            state.appendChild(parameterState, nullptr);
+        }
+
+        parameterState.setProperty("value", ranged->convertFrom0to1(normalisedValue), nullptr);
+    }
+
+    apvts.replaceState(state);
+
+    if (juce::isPositiveAndBelow(program, presetBank.getNumPresets()))
+        currentProgram.store(program);
+
+    return true;
+}
+
 // This creates new instances of the plugin
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
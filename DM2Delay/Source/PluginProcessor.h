@@ -2,17 +2,22 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "Parameters.h"
-#include "DSP/DelayLine.h"
-#include "DSP/Compander.h"
-#include "DSP/BBDModel.h"
-#include "DSP/Filter.h"
-#include "DSP/MixStage.h"
+#include "ParameterSnapshot.h"
+#include "RealtimeGuard.h"
+#include "HelperThread.h"
+#include "Meters.h"
+#include "Profiler.h"
+#include "PresetBank.h"
+#include "DSP/StageGraph.h"
+#include "DSP/Oversampler.h"
+#include "DSP/SoftClip.h"
 
 /**
  * DM-2 Delay Audio Processor
  * Main plugin class implementing DSP chain as per design doc
  */
-class DM2DelayAudioProcessor : public juce::AudioProcessor
+class DM2DelayAudioProcessor : public juce::AudioProcessor,
+                               private juce::Timer
 {
 public:
     DM2DelayAudioProcessor();
@@ -24,6 +29,7 @@ public:
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlockBypassed(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -46,30 +52,210 @@ public:
 
     // Access to parameter tree
     juce::AudioProcessorValueTreeState& getAPVTS() { return apvts; }
+
+    // Levels published every block, for the editor's meters
+    Meters& getMeters() { return meters; }
+
+    // Callback timing and per-stage cycle counts, for the editor's profiler overlay
+    Profiler& getProfiler() { return profiler; }
     
-    // Bypass control
-    void setBypass(bool shouldBypass) { isBypassed.store(shouldBypass); }
-    bool getBypass() const { return isBypassed.load(); }
+    // Bypass control (the host-visible bypass parameter)
+    juce::AudioProcessorParameter* getBypassParameter() const override;
+    void setBypass(bool shouldBypass);
+    bool getBypass() const { return parameterHandles.bypass->load() > 0.5f; }
+
+    /**
+     * Fix the BBD noise seed for reproducible (offline) renders
+     * Applied to every stage and channel group in prepareToPlay
+     */
+    void setNoiseSeed(juce::uint32 seed);
+
+    /**
+     * Store the delay rings as 32-bit float (default) or 16-bit fixed point
+     * Applied in prepareToPlay
+     */
+    void setCompactDelayStorage(bool shouldBeCompact) { useCompactDelayStorage = shouldBeCompact; }
+
+    /**
+     * While a stage idles (silent input, repeats decayed) keep emitting its BBD
+     * noise floor instead of passing its silent input through (default: pass)
+     */
+    void setIdleNoiseFloor(bool shouldKeepNoise) { keepIdleNoiseFloor.store(shouldKeepNoise); }
+
+    /**
+     * Render half of the channel groups on a real-time helper thread when the
+     * layout has more than one group (more than four channels, so never for
+     * stereo) and blocks are large (default: off; no thread is started otherwise)
+     * Applied in prepareToPlay
+     */
+    void setHelperThreadEnabled(bool shouldUseHelper) { useHelperThread = shouldUseHelper; }
+
+    /** Smallest chunk split with the helper: below it the handoff costs more than it saves */
+    static constexpr int helperMinChunkSize = 512;
+
+    /** How getStateInformation writes the state; setStateInformation reads either */
+    enum class StateFormat
+    {
+        binary, // compact and versioned, but only this release and later can load it
+        xml     // the parameter tree as XML, loadable by every release (default)
+    };
+
+    void setStateFormat(StateFormat newFormat) { stateFormat = newFormat; }
 
 private:
     juce::AudioProcessorValueTreeState apvts;
 
-    // DSP modules - Stage 1: stereo processing (left/right channels)
-    DelayLine delayLineLeft, delayLineRight;
-    Compander companderLeft, companderRight;
-    BBDModel bbdModelLeft, bbdModelRight;
-    Filter filterLeft, filterRight;
-    MixStage mixStageLeft, mixStageRight;
-
-    // DSP modules - Stage 2: for cascaded mode (separate instances to avoid state corruption)
-    DelayLine delayLine2Left, delayLine2Right;
-    Compander compander2Left, compander2Right;
-    BBDModel bbdModel2Left, bbdModel2Right;
-    Filter filter2Left, filter2Right;
-    MixStage mixStage2Left, mixStage2Right;
-
-    // Bypass state
-    std::atomic<bool> isBypassed{false};
+    // Every parameter's value atomic, resolved once; the audio thread captures a ParameterSnapshot from it per block
+    ParameterHandles parameterHandles;
+
+    // Factory programs, pre-built into snapshots of raw parameter values
+    PresetBank presetBank;
+    std::atomic<int> currentProgram{0};
+
+    // A recalled preset waiting for the audio thread to store it at the start of the next block,
+    // and for the message thread to publish it to the parameter objects (and the host)
+    std::atomic<const PresetBank::Snapshot*> pendingPreset{nullptr};
+    std::atomic<const PresetBank::Snapshot*> unpublishedPreset{nullptr};
+
+    StateFormat stateFormat = StateFormat::xml;
+
+    // Binary state: magic ("DM2B"), version, current program, parameter count, then an
+    // (ID, plain value) record per parameter, little-endian
+    static constexpr int binaryStateMagic = 0x42324d44;
+    static constexpr int binaryStateVersion = 1;
+
+    // One SIMD lane per channel: neighbouring channels advance together in a single pass
+    using SIMDSample = LaneOps::FloatVector;
+    static constexpr int channelsPerGroup = static_cast<int>(LaneOps::numLanes<SIMDSample>());
+
+    using StagePatch = StageGraph<SIMDSample>::Patch;
+
+    /** State for up to channelsPerGroup consecutive channels, one per lane */
+    struct ChannelGroup
+    {
+        StageGraph<SIMDSample> stages; // stage 1, and stage 2 in custom mode
+        Oversampler<SIMDSample> outputClipper; // oversampled output soft clip
+
+        // Interleaved input/output for block (stage-major) processing, one channel per lane
+        std::vector<SIMDSample> frames;
+
+        // What this group rendered in the current block, for the meters
+        Meters::Levels levels;
+
+        // Cycles spent in the output clip since the profiler last collected them
+        CycleCounter::Count outputClipCycles = 0;
+    };
+
+    // Channel-indexed DSP state: group g holds channels [g * channelsPerGroup, (g + 1) * channelsPerGroup)
+    // Allocated in prepareToPlay for the negotiated layout
+    std::unique_ptr<ChannelGroup[]> channelGroups;
+    int numChannelGroups = 0;
+
+    // Largest chunk the groups' scratch holds (the prepared block size)
+    int maxChunkSize = 0;
+
+    /** What every group needs to render one chunk, shared with the helper thread */
+    struct ChunkContext
+    {
+        float* const* channels = nullptr; // the buffer's write pointers, taken on the audio thread
+        int start = 0;
+        int numSamples = 0;
+        int numChannels = 0;
+        bool bypassing = false;
+        bool bypassTrails = false;
+        const StagePatch* patch = nullptr;
+    };
+
+    // Channel groups split across the audio thread and the helper for large blocks
+    HelperThread helperThread;
+    bool useHelperThread = false;
+    ChunkContext helperChunk;
+    int helperFirstGroup = 0;
+    int helperEndGroup = 0;
+
+    // Bypass crossfade position: 0 = processing, 1 = bypassed (audio thread only)
+    float bypassPosition = 0.0f;
+
+    // Equal-power crossfade length when bypass toggles
+    static constexpr double bypassFadeSeconds = 0.02;
+
+    // Fully bypassed without trails: the DSP state is stale and is cleared on return
+    bool effectSuspended = false;
+
+    // Per-sample crossfade gains and the latency-aligned dry signal, sized in prepareToPlay
+    std::vector<float> bypassEffectGains;
+    std::vector<float> bypassDryGains;
+    juce::AudioBuffer<float> bypassDryBuffer;
+
+    // Delays the bypassed signal by the reported latency, one ring per channel
+    juce::AudioBuffer<float> bypassDelayRing;
+    int bypassDelayLength = 0;
+    int bypassDelayIndex = 0;
+
+    // Oversampling factor currently applied on the audio thread, and the latency it implies
+    int oversamplingFactorLog2 = 0;
+    std::atomic<int> oversamplingLatency{0};
+
+    // Fixed BBD noise seed (offline renders); random per instance otherwise
+    bool useFixedNoiseSeed = false;
+    juce::uint32 noiseSeed = 0;
+
+    // 16-bit delay rings (opt-in): half the memory and bandwidth of float, below the BBD noise floor
+    bool useCompactDelayStorage = false;
+
+    std::atomic<bool> keepIdleNoiseFloor{false};
+
+    Meters meters;
+
+    Profiler profiler;
+
+    // Whether the stages time their sections: follows profiler.isEnabled() between blocks (audio thread)
+    bool stagesProfiling = false;
+
+    /** Switch every oversampler to a new factor (no allocation, resets their filters) */
+    void applyOversampling(int factorLog2);
+
+    /**
+     * Report the latency of the current oversampling factor to the host, and
+     * publish a recalled preset to the parameter objects
+     * Polled on the message thread: posting a message from processBlock can
+     * lock and allocate
+     */
+    void timerCallback() override;
+
+    /**
+     * Shared body of processBlock and processBlockBypassed
+     * @param bypassRequested Fade to (or stay in) bypass
+     */
+    void renderBlock(juce::AudioBuffer<float>& buffer, bool bypassRequested);
+
+    /**
+     * renderBlock, timed for the profiler while it is enabled
+     * Every group's section cycles are collected once the whole block (the
+     * helper's share included) has been rendered
+     */
+    void renderTimedBlock(juce::AudioBuffer<float>& buffer, bool bypassRequested);
+
+    /** Delay channel samples [start, start + numSamples) by the current latency, in place */
+    void delayBypassedSignal(juce::AudioBuffer<float>& signal, int start, int numSamples);
+
+    /** Keep the bypass delay fed while processing, so a bypass fade starts from real input */
+    void primeBypassDelay(const juce::AudioBuffer<float>& signal, int start, int numSamples);
+
+    /** Render channel groups [firstGroup, endGroup) for one chunk */
+    void renderGroups(const ChunkContext& chunk, int firstGroup, int endGroup);
+
+    /** HelperThread job: the helper's share of the groups */
+    static void renderHelperGroups(void* processor);
+
+    /** Write every parameter in the binary state format */
+    void writeBinaryState(juce::MemoryBlock& destData) const;
+
+    /** Restore a binary state; false if the data is not in the binary format */
+    bool readBinaryState(const void* data, int sizeInBytes);
+
+    /** Stage settings and routing from a block's parameter values */
+    StagePatch readStagePatch(const ParameterSnapshot& parameters) const;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DM2DelayAudioProcessor)
 };
@@ -0,0 +1,96 @@
+#include "PresetBank.h"
+#include "Parameters.h"
+
+namespace
+{
+    /** A factory preset in the parameters' own units (ms, %, Hz, switch positions) */
+    struct FactoryPreset
+    {
+        const char* name;
+        float delayTime, feedback, mix, tone, modulation;
+        float mode, engine, routing;
+        float delayTime2, feedback2, mix2, tone2, modulation2;
+    };
+
+    // Stage 2 values only matter in custom mode, but are set anyway so every preset recalls the same sound.
+    // Delays beyond the pedal's 300 ms switch the preset to the long delay parameters
+    const FactoryPreset factoryPresets[] =
+    {
+        // name                delay  fb    mix   tone  mod   mode  engine route  delay2 fb2   mix2  tone2 mod2
+        { "DM-2 Default",      100.0f, 30.0f, 50.0f, 70.0f, 0.0f, 0.0f, 0.0f, 0.0f, 100.0f, 30.0f, 50.0f, 70.0f, 0.0f },
+        { "Slapback",           85.0f,  8.0f, 40.0f, 80.0f, 0.0f, 0.0f, 0.0f, 0.0f, 100.0f, 30.0f, 50.0f, 70.0f, 0.0f },
+        { "Analog Echo",       300.0f, 45.0f, 45.0f, 55.0f, 0.6f, 0.0f, 1.0f, 0.0f, 100.0f, 30.0f, 50.0f, 70.0f, 0.0f },
+        { "Tape Warble",       380.0f, 40.0f, 50.0f, 45.0f, 1.2f, 0.0f, 1.0f, 0.0f, 100.0f, 30.0f, 50.0f, 70.0f, 0.0f },
+        { "Chorus Doubler",     25.0f,  0.0f, 50.0f, 85.0f, 1.5f, 0.0f, 0.0f, 0.0f, 100.0f, 30.0f, 50.0f, 70.0f, 0.0f },
+        { "Runaway",           450.0f, 88.0f, 55.0f, 45.0f, 0.4f, 0.0f, 1.0f, 0.0f, 100.0f, 30.0f, 50.0f, 70.0f, 0.0f },
+        { "Cascade Wash",      420.0f, 55.0f, 45.0f, 50.0f, 0.3f, 1.0f, 0.0f, 0.0f, 650.0f, 60.0f, 60.0f, 40.0f, 0.4f },
+        { "Dual Heads",        250.0f, 40.0f, 50.0f, 65.0f, 0.0f, 1.0f, 1.0f, 1.0f, 375.0f, 40.0f, 50.0f, 55.0f, 0.0f }
+    };
+}
+
+void PresetBank::Snapshot::store() const noexcept
+{
+    for (const auto& entry : entries)
+        entry.rawValue->store(entry.value);
+}
+
+void PresetBank::Snapshot::publish() const
+{
+    for (const auto& entry : entries)
+        if (entry.parameter != nullptr)
+            entry.parameter->setValueNotifyingHost(entry.parameter->convertTo0to1(entry.value));
+}
+
+PresetBank::PresetBank(juce::AudioProcessorValueTreeState& apvts)
+{
+    for (const auto& preset : factoryPresets)
+    {
+        const bool longDelay = juce::jmax(preset.delayTime, preset.delayTime2) > Parameters::delayTimeMax;
+
+        const std::pair<const juce::String&, float> values[] =
+        {
+            { Parameters::longDelayID, longDelay ? 1.0f : 0.0f },
+            { Parameters::delayTimeID, juce::jmin(preset.delayTime, Parameters::delayTimeMax) },
+            { Parameters::delayTimeLongID, preset.delayTime },
+            { Parameters::feedbackID, preset.feedback },
+            { Parameters::mixID, preset.mix },
+            { Parameters::toneID, preset.tone },
+            { Parameters::modulationID, preset.modulation },
+            { Parameters::modeID, preset.mode },
+            { Parameters::engineID, preset.engine },
+            { Parameters::routingID, preset.routing },
+            { Parameters::delayTime2ID, juce::jmin(preset.delayTime2, Parameters::delayTimeMax) },
+            { Parameters::delayTimeLong2ID, preset.delayTime2 },
+            { Parameters::feedback2ID, preset.feedback2 },
+            { Parameters::mix2ID, preset.mix2 },
+            { Parameters::tone2ID, preset.tone2 },
+            { Parameters::modulation2ID, preset.modulation2 }
+        };
+
+        Snapshot snapshot;
+
+        for (const auto& value : values)
+        {
+            Snapshot::Entry entry;
+            entry.rawValue = apvts.getRawParameterValue(value.first);
+            entry.parameter = apvts.getParameter(value.first);
+            jassert(entry.rawValue != nullptr);
+
+            // Stored exactly as the parameter would hold it, so recall and publish agree
+            entry.value = entry.parameter != nullptr
+                ? entry.parameter->convertFrom0to1(entry.parameter->convertTo0to1(value.second))
+                : value.second;
+
+            if (entry.rawValue != nullptr)
+                snapshot.entries.push_back(entry);
+        }
+
+        snapshots.push_back(std::move(snapshot));
+        names.add(preset.name);
+    }
+}
+
+juce::String PresetBank::getName(int index) const
+{
+    return names[index];
+}
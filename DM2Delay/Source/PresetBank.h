@@ -0,0 +1,61 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <atomic>
+#include <vector>
+
+/**
+ * PresetBank - The factory programs, each pre-built into a parameter snapshot
+ *
+ * A snapshot resolves every parameter its preset sets to the parameter's raw
+ * value atomic up front, so recalling it is a flat run of atomic stores: no
+ * string lookups, allocation or locks, and safe on the audio thread. The
+ * host-facing parameter objects are brought in line afterwards on the
+ * message thread (publish()).
+ *
+ * Presets set the sound only. Bypass, trails and oversampling (which changes
+ * the latency) are left as they are.
+ */
+class PresetBank
+{
+public:
+    /** One preset, resolved against the processor's parameters */
+    class Snapshot
+    {
+    public:
+        /** Write the preset straight into the raw parameter values (any thread; wait-free) */
+        void store() const noexcept;
+
+        /** Set the parameter objects to the preset and notify the host (message thread) */
+        void publish() const;
+
+    private:
+        friend class PresetBank;
+
+        struct Entry
+        {
+            std::atomic<float>* rawValue = nullptr;
+            juce::RangedAudioParameter* parameter = nullptr;
+            float value = 0.0f; // plain value, in the parameter's own units
+        };
+
+        std::vector<Entry> entries;
+    };
+
+    /** Build every snapshot (message thread; allocates) */
+    explicit PresetBank(juce::AudioProcessorValueTreeState& apvts);
+    ~PresetBank() = default;
+
+    int getNumPresets() const { return static_cast<int>(snapshots.size()); }
+
+    juce::String getName(int index) const;
+
+    /** The pre-built snapshot of preset index (0 <= index < getNumPresets()) */
+    const Snapshot& getSnapshot(int index) const { return snapshots[static_cast<size_t>(index)]; }
+
+private:
+    std::vector<Snapshot> snapshots;
+    juce::StringArray names;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetBank)
+};
@@ -0,0 +1,226 @@
+#include "Profiler.h"
+
+namespace
+{
+    // Running totals have a single writer, so a relaxed load and store is all an update needs
+    template <typename Type>
+    void addTo(std::atomic<Type>& total, Type amount) noexcept
+    {
+        total.store(total.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    const char* const sectionNames[] = { "compress", "delay", "bbd", "expand", "filter", "mix" };
+    static_assert(juce::numElementsInArray(sectionNames) == Profiler::numSections,
+                  "Every stage section needs a name");
+}
+
+double Profiler::Block::getLoad(double sampleRate) const
+{
+    return numSamples > 0 ? seconds * sampleRate / static_cast<double>(numSamples) : 0.0;
+}
+
+Profiler::Profiler()
+    : fifoBlocks(static_cast<size_t>(fifoSize))
+{
+    clearTotals();
+}
+
+void Profiler::prepare(double sampleRate, int maxBlockSize)
+{
+    currentSampleRate = sampleRate;
+    currentBlockSize = maxBlockSize;
+    loadMeasurer.reset(sampleRate, maxBlockSize);
+    clearTotals();
+    resetRequested.store(false);
+}
+
+void Profiler::clearTotals() noexcept
+{
+    for (auto& bin : loadHistogram)
+        bin.store(0, std::memory_order_relaxed);
+
+    for (auto& column : columnCycles)
+        column.store(0, std::memory_order_relaxed);
+
+    numBlocks.store(0, std::memory_order_relaxed);
+    deadlineMisses.store(0, std::memory_order_relaxed);
+    droppedBlocks.store(0, std::memory_order_relaxed);
+    totalSamples.store(0, std::memory_order_relaxed);
+    maxLoad.store(0.0f, std::memory_order_relaxed);
+    totalCycles.store(0, std::memory_order_relaxed);
+}
+
+void Profiler::publish(const Block& block) noexcept
+{
+    if (resetRequested.exchange(false, std::memory_order_acquire))
+        clearTotals();
+
+    // The measurer keeps its own smoothed load and xrun count (it never blocks the audio thread)
+    loadMeasurer.registerRenderTime(block.seconds * 1000.0, block.numSamples);
+
+    const double load = block.getLoad(currentSampleRate);
+    const int bin = juce::jlimit(0, numLoadBins - 1, static_cast<int>(load * 100.0));
+    addTo(loadHistogram[static_cast<size_t>(bin)], juce::int64(1));
+
+    if (load > 1.0)
+        addTo(deadlineMisses, juce::int64(1));
+
+    if (static_cast<float>(load) > maxLoad.load(std::memory_order_relaxed))
+        maxLoad.store(static_cast<float>(load), std::memory_order_relaxed);
+
+    for (size_t column = 0; column < columnCycles.size(); ++column)
+        addTo(columnCycles[column], block.cycles[column]);
+
+    addTo(totalCycles, block.totalCycles);
+    addTo(totalSamples, juce::int64(block.numSamples));
+
+    // The record for the history, unless the message thread has fallen behind
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 > 0)
+    {
+        auto& record = fifoBlocks[static_cast<size_t>(start1)];
+        record = block;
+        record.index = numBlocks.load(std::memory_order_relaxed);
+        fifo.finishedWrite(1);
+    }
+    else
+    {
+        addTo(droppedBlocks, juce::int64(1));
+    }
+
+    // Last, so a reader that sees this count sees the totals that go with it
+    numBlocks.store(numBlocks.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void Profiler::reset()
+{
+    resetRequested.store(true, std::memory_order_release);
+    loadMeasurer.reset(currentSampleRate, currentBlockSize);
+
+    // Whatever is still in the FIFO belongs to the run being discarded
+    fifo.finishedRead(fifo.getNumReady());
+    history.clear();
+}
+
+double Profiler::getLoadPercentile(double proportion, juce::int64 blocks) const
+{
+    const auto target = static_cast<juce::int64>(std::ceil(proportion * static_cast<double>(blocks)));
+    juce::int64 count = 0;
+
+    for (int bin = 0; bin < numLoadBins - 1; ++bin)
+    {
+        count += loadHistogram[static_cast<size_t>(bin)].load(std::memory_order_relaxed);
+
+        if (count >= target)
+            return static_cast<double>(bin + 1) / 100.0;
+    }
+
+    // Beyond the histogram: the maximum is the best bound there is
+    return static_cast<double>(maxLoad.load(std::memory_order_relaxed));
+}
+
+Profiler::Summary Profiler::getSummary() const
+{
+    Summary summary;
+
+    summary.numBlocks = numBlocks.load(std::memory_order_acquire);
+    summary.deadlineMisses = deadlineMisses.load(std::memory_order_relaxed);
+    summary.droppedBlocks = droppedBlocks.load(std::memory_order_relaxed);
+    summary.xruns = loadMeasurer.getXRunCount();
+    summary.averageLoad = loadMeasurer.getLoadAsProportion();
+
+    if (summary.numBlocks == 0)
+        return summary;
+
+    summary.medianLoad = getLoadPercentile(0.5, summary.numBlocks);
+    summary.p99Load = getLoadPercentile(0.99, summary.numBlocks);
+    summary.maxLoad = static_cast<double>(maxLoad.load(std::memory_order_relaxed));
+
+    const double samples = static_cast<double>(juce::jmax(juce::int64(1), totalSamples.load(std::memory_order_relaxed)));
+    summary.totalCyclesPerSample = static_cast<double>(totalCycles.load(std::memory_order_relaxed)) / samples;
+
+    for (size_t column = 0; column < columnCycles.size(); ++column)
+        summary.cyclesPerSample[column] = static_cast<double>(columnCycles[column].load(std::memory_order_relaxed)) / samples;
+
+    return summary;
+}
+
+void Profiler::collect()
+{
+    const int numReady = fifo.getNumReady();
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(numReady, start1, size1, start2, size2);
+
+    for (int i = 0; i < size1; ++i)
+        history.push_back(fifoBlocks[static_cast<size_t>(start1 + i)]);
+
+    for (int i = 0; i < size2; ++i)
+        history.push_back(fifoBlocks[static_cast<size_t>(start2 + i)]);
+
+    fifo.finishedRead(size1 + size2);
+
+    while (history.size() > maxHistory)
+        history.pop_front();
+}
+
+juce::String Profiler::getColumnName(int column)
+{
+    if (column == outputClipColumn)
+        return "clip";
+
+    return "S" + juce::String(column / numSections + 1) + " " + sectionNames[column % numSections];
+}
+
+bool Profiler::writeCsv(const juce::File& file)
+{
+    collect();
+
+    const auto summary = getSummary();
+    juce::String csv;
+
+    // Summary as comment lines, so the tables below still load as plain CSV
+    csv << "# DM-2 Delay profile, " << juce::Time::getCurrentTime().toISO8601(true) << "\n"
+        << "# sample rate," << currentSampleRate << "\n"
+        << "# blocks," << summary.numBlocks << "\n"
+        << "# deadline misses," << summary.deadlineMisses << "\n"
+        << "# xruns," << summary.xruns << "\n"
+        << "# dropped records," << summary.droppedBlocks << "\n"
+        << "# load average (%)," << summary.averageLoad * 100.0 << "\n"
+        << "# load p50 (%)," << summary.medianLoad * 100.0 << "\n"
+        << "# load p99 (%)," << summary.p99Load * 100.0 << "\n"
+        << "# load max (%)," << summary.maxLoad * 100.0 << "\n"
+        << "# cycles per sample," << summary.totalCyclesPerSample << "\n";
+
+    for (int column = 0; column < numColumns; ++column)
+        csv << "# " << getColumnName(column) << " cycles per sample,"
+            << summary.cyclesPerSample[static_cast<size_t>(column)] << "\n";
+
+    csv << "\nload (%),blocks\n";
+
+    for (int bin = 0; bin < numLoadBins; ++bin)
+        if (const auto count = loadHistogram[static_cast<size_t>(bin)].load(std::memory_order_relaxed))
+            csv << bin << "," << count << "\n";
+
+    csv << "\nblock,samples,time (us),load (%),cycles";
+
+    for (int column = 0; column < numColumns; ++column)
+        csv << "," << getColumnName(column);
+
+    csv << "\n";
+
+    for (const auto& block : history)
+    {
+        csv << block.index << "," << block.numSamples << ","
+            << block.seconds * 1.0e6 << "," << block.getLoad(currentSampleRate) * 100.0 << ","
+            << static_cast<juce::int64>(block.totalCycles);
+
+        for (const auto cycles : block.cycles)
+            csv << "," << static_cast<juce::int64>(cycles);
+
+        csv << "\n";
+    }
+
+    return file.replaceWithText(csv);
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <atomic>
+#include <deque>
+#include "Parameters.h"
+#include "DSP/BBDStage.h"
+#include "DSP/CycleCounter.h"
+
+/**
+ * Profiler - Where the audio callback's time goes, and how close it runs to its deadline
+ *
+ * Off by default; the editor's debug overlay switches it on. While on, the
+ * audio thread times every block against its buffer period (also fed to a
+ * juce::AudioProcessLoadMeasurer) and counts cycles per section of every
+ * stage. Publishing is wait-free: running totals and a histogram of block
+ * load live in atomics, and each block's record goes through a FIFO, which
+ * the message thread drains into a short history for CSV export. When the
+ * FIFO is full, records are dropped (and counted) rather than waited for.
+ */
+class Profiler
+{
+public:
+    static constexpr int numSections = BBDStage<float>::numSections;
+
+    /** Cycle columns: every section of every stage, then the output clip */
+    static constexpr int numColumns = Parameters::numStages * numSections + 1;
+    static constexpr int outputClipColumn = numColumns - 1;
+
+    /** One block's measurements (filled on the audio thread) */
+    struct Block
+    {
+        juce::int64 index = 0;                  // assigned by publish
+        int numSamples = 0;
+        double seconds = 0.0;                   // wall time of the whole callback
+        CycleCounter::Count totalCycles = 0;    // the whole callback, in cycle counts
+        std::array<CycleCounter::Count, numColumns> cycles{};
+
+        /** Wall time as a proportion of the buffer period (above 1 = missed the deadline) */
+        double getLoad(double sampleRate) const;
+    };
+
+    /** Everything since the last reset (read on the message thread) */
+    struct Summary
+    {
+        juce::int64 numBlocks = 0;
+        juce::int64 deadlineMisses = 0;  // blocks that took longer than their buffer period
+        juce::int64 droppedBlocks = 0;   // records the history missed because the FIFO was full
+        int xruns = 0;                   // as counted by the load measurer
+        double averageLoad = 0.0;        // the load measurer's smoothed load
+        double medianLoad = 0.0;         // per-block load percentiles, to the histogram's 1% resolution
+        double p99Load = 0.0;
+        double maxLoad = 0.0;
+        double totalCyclesPerSample = 0.0;
+        std::array<double, numColumns> cyclesPerSample{};
+    };
+
+    Profiler();
+    ~Profiler() = default;
+
+    /** Turn timing on or off (any thread; takes effect from the next block) */
+    void setEnabled(bool shouldProfile) { enabled.store(shouldProfile); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    /** Set the buffer period blocks are measured against, and start afresh (before playback) */
+    void prepare(double sampleRate, int maxBlockSize);
+
+    /** Add one block (audio thread; wait-free) */
+    void publish(const Block& block) noexcept;
+
+    /** Start the statistics afresh (message thread; the audio thread clears its totals on its next block) */
+    void reset();
+
+    /** The statistics since the last reset (message thread) */
+    Summary getSummary() const;
+
+    /** Move the records published since the last call into the history (message thread) */
+    void collect();
+
+    /** Write the summary, the load histogram and the recorded blocks as CSV (message thread) */
+    bool writeCsv(const juce::File& file);
+
+    /** Short name of a cycle column, such as "S1 delay" or "clip" */
+    static juce::String getColumnName(int column);
+
+private:
+    std::atomic<bool> enabled{false};
+    std::atomic<bool> resetRequested{false};
+
+    double currentSampleRate = 44100.0;
+    int currentBlockSize = 0;
+
+    // Callback load against the buffer period, as the host would see it
+    juce::AudioProcessLoadMeasurer loadMeasurer;
+
+    // Per-block load in 1% bins from 0 to 200%; the last bin takes everything beyond
+    static constexpr int numLoadBins = 201;
+    std::array<std::atomic<juce::int64>, numLoadBins> loadHistogram;
+
+    // Running totals (written by the audio thread only, so plain stores suffice)
+    std::atomic<juce::int64> numBlocks{0};
+    std::atomic<juce::int64> deadlineMisses{0};
+    std::atomic<juce::int64> droppedBlocks{0};
+    std::atomic<juce::int64> totalSamples{0};
+    std::atomic<float> maxLoad{0.0f};
+    std::atomic<CycleCounter::Count> totalCycles{0};
+    std::array<std::atomic<CycleCounter::Count>, numColumns> columnCycles;
+
+    // Block records on their way to the message thread
+    static constexpr int fifoSize = 1024;
+    juce::AbstractFifo fifo{fifoSize};
+    std::vector<Block> fifoBlocks;
+
+    // The most recent records (message thread only)
+    static constexpr size_t maxHistory = 16384;
+    std::deque<Block> history;
+
+    /** Clear the running totals (audio thread, or before playback) */
+    void clearTotals() noexcept;
+
+    /** Upper edge of the load bin that reaches the given proportion of blocks */
+    double getLoadPercentile(double proportion, juce::int64 blocks) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Profiler)
+};
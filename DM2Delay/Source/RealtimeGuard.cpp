@@ -0,0 +1,189 @@
+#include "RealtimeGuard.h"
+
+#if DM2DELAY_REALTIME_GUARD
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if JUCE_LINUX
+ #include <dlfcn.h>
+ #include <pthread.h>
+#endif
+
+namespace
+{
+    // Plain thread_locals: no constructors, so reading them never allocates
+    thread_local int audioThreadDepth = 0;
+    thread_local int allowedDepth = 0;
+
+    [[noreturn]] void reportViolation(const char* what)
+    {
+        // Building the report allocates; don't trap on it
+        ++allowedDepth;
+
+        std::fprintf(stderr, "\n*** Real-time violation: %s called inside processBlock ***\n%s\n",
+                     what, juce::SystemStats::getStackBacktrace().toRawUTF8());
+        std::fflush(stderr);
+
+        jassertfalse;
+        std::abort();
+    }
+
+    inline void check(const char* what)
+    {
+        if (audioThreadDepth > 0 && allowedDepth == 0)
+            reportViolation(what);
+    }
+
+    void* allocate(std::size_t size, const char* what)
+    {
+        check(what);
+        return std::malloc(size > 0 ? size : 1);
+    }
+
+    void* allocateAligned(std::size_t size, std::size_t alignment, const char* what)
+    {
+        check(what);
+        size = size > 0 ? size : 1;
+
+       #if JUCE_WINDOWS
+        return _aligned_malloc(size, alignment);
+       #else
+        void* pointer = nullptr;
+        return posix_memalign(&pointer, juce::jmax(alignment, sizeof(void*)), size) == 0 ? pointer : nullptr;
+       #endif
+    }
+
+    void release(void* pointer, const char* what) noexcept
+    {
+        if (pointer != nullptr)
+            check(what);
+
+        std::free(pointer);
+    }
+
+    void releaseAligned(void* pointer, const char* what) noexcept
+    {
+        if (pointer != nullptr)
+            check(what);
+
+       #if JUCE_WINDOWS
+        _aligned_free(pointer);
+       #else
+        std::free(pointer);
+       #endif
+    }
+}
+
+namespace RealtimeGuard
+{
+    void enterAudioThread() noexcept { ++audioThreadDepth; }
+    void exitAudioThread() noexcept  { --audioThreadDepth; }
+    void enterAllowed() noexcept     { ++allowedDepth; }
+    void exitAllowed() noexcept      { --allowedDepth; }
+}
+
+//==============================================================================
+// Global allocation functions
+
+void* operator new(std::size_t size)
+{
+    if (auto* pointer = allocate(size, "operator new"))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    if (auto* pointer = allocate(size, "operator new[]"))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept   { return allocate(size, "operator new"); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size, "operator new[]"); }
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (auto* pointer = allocateAligned(size, static_cast<std::size_t>(alignment), "operator new"))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    if (auto* pointer = allocateAligned(size, static_cast<std::size_t>(alignment), "operator new[]"))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept                          { release(pointer, "operator delete"); }
+void operator delete[](void* pointer) noexcept                        { release(pointer, "operator delete[]"); }
+void operator delete(void* pointer, std::size_t) noexcept             { release(pointer, "operator delete"); }
+void operator delete[](void* pointer, std::size_t) noexcept           { release(pointer, "operator delete[]"); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept   { release(pointer, "operator delete"); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { release(pointer, "operator delete[]"); }
+
+void operator delete(void* pointer, std::align_val_t) noexcept              { releaseAligned(pointer, "operator delete"); }
+void operator delete[](void* pointer, std::align_val_t) noexcept            { releaseAligned(pointer, "operator delete[]"); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { releaseAligned(pointer, "operator delete"); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { releaseAligned(pointer, "operator delete[]"); }
+
+//==============================================================================
+// C allocator and mutex interposition (glibc lets an executable replace these)
+
+#if JUCE_LINUX
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void __libc_free(void*);
+
+    void* malloc(size_t size)
+    {
+        check("malloc");
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size)
+    {
+        check("calloc");
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, size_t size)
+    {
+        check("realloc");
+        return __libc_realloc(pointer, size);
+    }
+
+    void free(void* pointer)
+    {
+        if (pointer != nullptr)
+            check("free");
+
+        __libc_free(pointer);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex)
+    {
+        using LockFunction = int (*)(pthread_mutex_t*);
+
+        // Resolved on first use, which happens during static initialisation
+        static LockFunction realLock = nullptr;
+        if (realLock == nullptr)
+            realLock = reinterpret_cast<LockFunction>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+
+        check("pthread_mutex_lock");
+        return realLock(mutex);
+    }
+}
+#endif
+
+#endif // DM2DELAY_REALTIME_GUARD
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+/**
+ * RealtimeGuard - Catches allocations and locks on the audio thread
+ *
+ * Built with DM2DELAY_REALTIME_GUARD=1 (the DM2DelayRealtimeCheck tool), the
+ * processor marks its thread for the duration of processBlock. Global
+ * operator new/delete, and on Linux malloc/calloc/realloc/free and
+ * pthread_mutex_lock (which std::mutex and juce::CriticalSection use), are
+ * intercepted there and any call on a marked thread prints a stack trace
+ * and aborts.
+ *
+ * In every other build the scopes below are empty and compile away.
+ */
+#ifndef DM2DELAY_REALTIME_GUARD
+ #define DM2DELAY_REALTIME_GUARD 0
+#endif
+
+namespace RealtimeGuard
+{
+   #if DM2DELAY_REALTIME_GUARD
+    void enterAudioThread() noexcept;
+    void exitAudioThread() noexcept;
+    void enterAllowed() noexcept;
+    void exitAllowed() noexcept;
+   #else
+    inline void enterAudioThread() noexcept {}
+    inline void exitAudioThread() noexcept {}
+    inline void enterAllowed() noexcept {}
+    inline void exitAllowed() noexcept {}
+   #endif
+
+    /** True when the interceptors are compiled in */
+    constexpr bool isEnabled() { return DM2DELAY_REALTIME_GUARD != 0; }
+
+    /** Marks the current thread as real-time for the lifetime of the scope */
+    struct ScopedAudioThread
+    {
+        ScopedAudioThread() noexcept { enterAudioThread(); }
+        ~ScopedAudioThread() noexcept { exitAudioThread(); }
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedAudioThread)
+    };
+
+    /** Suspends the checks on the current thread, for calls known to be safe */
+    struct ScopedAllow
+    {
+        ScopedAllow() noexcept { enterAllowed(); }
+        ~ScopedAllow() noexcept { exitAllowed(); }
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedAllow)
+    };
+}
@@ -0,0 +1,277 @@
+#include <juce_audio_utils/juce_audio_utils.h>
+#include "PluginProcessor.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+/**
+ * DM2DelayBatch - Offline batch renderer
+ * Runs every audio file in a folder through the same DM2DelayAudioProcessor
+ * chain the plugin uses, spreading files across all cores.
+ */
+namespace
+{
+    std::mutex logLock;
+
+    void log(const juce::String& message)
+    {
+        std::lock_guard<std::mutex> guard(logLock);
+        std::cout << message << std::endl;
+    }
+
+    void printUsage()
+    {
+        std::cout
+            << "Usage: DM2DelayBatch --input=<folder> --output=<folder> [options]\n"
+            << "\n"
+            << "Options:\n"
+            << "  --state=<file>      Load a saved plugin state blob before applying overrides\n"
+            << "  --threads=<n>       Worker threads (default: all cores)\n"
+            << "  --block=<n>         Processing block size in samples (default: 512)\n"
+            << "  --tail=<seconds>    Extra render time after the input ends (default: plugin tail length)\n"
+            << "  --bits=<16|24|32>   Output bit depth (default: input bit depth)\n"
+            << "  --seed=<n>          Fixed BBD noise seed, for bit-identical re-renders\n"
+            << "  --storage=<int16|float>\n"
+            << "                      Delay ring format (default: float)\n"
+            << "  --<parameterID>=<value>\n"
+            << "                      Override any plugin parameter in its own units,\n"
+            << "                      e.g. --delayTime=250 --feedback=60 --mode=1\n";
+    }
+
+    struct RenderSettings
+    {
+        juce::File outputFolder;
+        int blockSize = 512;
+        double tailSeconds = -1.0; // negative: ask the processor
+        int bitsPerSample = 0;     // zero: match the input file
+    };
+
+    /** Load an optional state blob, then apply any --<parameterID>=<value> overrides */
+    void configureProcessor(DM2DelayAudioProcessor& processor, const juce::ArgumentList& args,
+                            const juce::MemoryBlock& state)
+    {
+        if (state.getSize() > 0)
+            processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+
+        if (args.containsOption("--seed"))
+            processor.setNoiseSeed(static_cast<juce::uint32>(args.getValueForOption("--seed").getLargeIntValue()));
+
+        if (args.containsOption("--storage"))
+            processor.setCompactDelayStorage(args.getValueForOption("--storage") == "int16");
+
+        for (auto* parameter : processor.getParameters())
+        {
+            auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+            if (ranged == nullptr)
+                continue;
+
+            auto value = args.getValueForOption("--" + ranged->paramID);
+            if (value.isEmpty())
+                continue;
+
+            ranged->setValueNotifyingHost(ranged->convertTo0to1(value.getFloatValue()));
+        }
+    }
+
+    /** Render one file; returns an error message, or an empty string on success */
+    juce::String renderFile(DM2DelayAudioProcessor& processor, juce::AudioFormatManager& formats,
+                            const juce::File& inputFile, const RenderSettings& settings)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(inputFile));
+        if (reader == nullptr)
+            return "unreadable audio file";
+
+        const int numChannels = static_cast<int>(reader->numChannels);
+        const double sampleRate = reader->sampleRate;
+
+        // Match the processor's buses to the file
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+        layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+
+        if (! processor.setBusesLayout(layout))
+            return "unsupported channel count (" + juce::String(numChannels) + ")";
+
+        processor.setNonRealtime(true);
+        processor.setRateAndBufferSizeDetails(sampleRate, settings.blockSize);
+        processor.prepareToPlay(sampleRate, settings.blockSize);
+
+        auto outputFile = settings.outputFolder.getChildFile(inputFile.getFileNameWithoutExtension() + ".wav");
+        outputFile.deleteFile();
+
+        std::unique_ptr<juce::FileOutputStream> stream(outputFile.createOutputStream());
+        if (stream == nullptr || ! stream->openedOk())
+            return "can't write " + outputFile.getFullPathName();
+
+        const int bitsPerSample = settings.bitsPerSample > 0 ? settings.bitsPerSample
+                                                             : juce::jlimit(16, 32, static_cast<int>(reader->bitsPerSample));
+
+        juce::WavAudioFormat wavFormat;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wavFormat.createWriterFor(
+            stream.get(), sampleRate, static_cast<unsigned int>(numChannels), bitsPerSample, {}, 0));
+
+        if (writer == nullptr)
+            return "can't create a " + juce::String(bitsPerSample) + "-bit WAV writer";
+
+        stream.release(); // the writer owns it now
+
+        const double tailSeconds = settings.tailSeconds >= 0.0 ? settings.tailSeconds
+                                                               : processor.getTailLengthSeconds();
+        const auto tailSamples = static_cast<juce::int64>(std::ceil(tailSeconds * sampleRate));
+
+        // Oversampling delays the output; drop that much from the start so the
+        // render lines up with the input, and run on for as long again at the end
+        auto samplesToSkip = static_cast<juce::int64>(processor.getLatencySamples());
+        const auto totalSamples = reader->lengthInSamples + tailSamples + samplesToSkip;
+
+        juce::AudioBuffer<float> buffer(numChannels, settings.blockSize);
+        juce::MidiBuffer midi;
+
+        for (juce::int64 position = 0; position < totalSamples; position += settings.blockSize)
+        {
+            const int numSamples = static_cast<int>(juce::jmin<juce::int64>(settings.blockSize, totalSamples - position));
+
+            // Past the end of the file the reader pads with silence, which renders the tail
+            buffer.setSize(numChannels, numSamples, false, false, true);
+            reader->read(&buffer, 0, numSamples, position, true, true);
+
+            processor.processBlock(buffer, midi);
+
+            const int skip = static_cast<int>(juce::jmin<juce::int64>(samplesToSkip, numSamples));
+            samplesToSkip -= skip;
+
+            if (skip < numSamples && ! writer->writeFromAudioSampleBuffer(buffer, skip, numSamples - skip))
+                return "write failed";
+        }
+
+        processor.releaseResources();
+        return {};
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    // APVTS needs a message manager; the main thread plays that role but never dispatches
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    auto cwd = juce::File::getCurrentWorkingDirectory();
+    auto inputPath = args.getValueForOption("--input|-i");
+    auto outputPath = args.getValueForOption("--output|-o");
+
+    if (inputPath.isEmpty() || outputPath.isEmpty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    auto inputFolder = cwd.getChildFile(inputPath);
+    if (! inputFolder.isDirectory())
+    {
+        std::cerr << "Input folder not found: " << inputFolder.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    RenderSettings settings;
+    settings.outputFolder = cwd.getChildFile(outputPath);
+
+    if (! settings.outputFolder.createDirectory())
+    {
+        std::cerr << "Can't create output folder: " << settings.outputFolder.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    if (args.containsOption("--block"))
+        settings.blockSize = juce::jlimit(16, 65536, args.getValueForOption("--block").getIntValue());
+
+    if (args.containsOption("--tail"))
+        settings.tailSeconds = juce::jmax(0.0, args.getValueForOption("--tail").getDoubleValue());
+
+    if (args.containsOption("--bits"))
+        settings.bitsPerSample = juce::jlimit(16, 32, args.getValueForOption("--bits").getIntValue());
+
+    juce::MemoryBlock state;
+    if (args.containsOption("--state"))
+    {
+        auto stateFile = cwd.getChildFile(args.getValueForOption("--state"));
+        if (! stateFile.loadFileAsData(state))
+        {
+            std::cerr << "Can't read state file: " << stateFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    auto files = inputFolder.findChildFiles(juce::File::findFiles, false, "*.wav;*.aif;*.aiff;*.flac");
+    if (files.isEmpty())
+    {
+        std::cerr << "No audio files in " << inputFolder.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    // Longest files first, so the last job to finish is a short one
+    std::sort(files.begin(), files.end(), [](const juce::File& a, const juce::File& b)
+    {
+        return a.getSize() > b.getSize();
+    });
+
+    int numThreads = static_cast<int>(std::thread::hardware_concurrency());
+    if (args.containsOption("--threads"))
+        numThreads = args.getValueForOption("--threads").getIntValue();
+    numThreads = juce::jlimit(1, files.size(), juce::jmax(1, numThreads));
+
+    // One processor and format manager per worker, built up front on the message thread
+    std::vector<std::unique_ptr<DM2DelayAudioProcessor>> processors;
+    std::vector<std::unique_ptr<juce::AudioFormatManager>> formatManagers;
+
+    for (int i = 0; i < numThreads; ++i)
+    {
+        processors.push_back(std::make_unique<DM2DelayAudioProcessor>());
+        configureProcessor(*processors.back(), args, state);
+
+        formatManagers.push_back(std::make_unique<juce::AudioFormatManager>());
+        formatManagers.back()->registerBasicFormats();
+    }
+
+    WorkStealingPool pool(numThreads);
+    std::atomic<int> numFailed{0};
+
+    for (auto& file : files)
+    {
+        pool.addJob([&, file](int worker)
+        {
+            auto error = renderFile(*processors[static_cast<size_t>(worker)],
+                                    *formatManagers[static_cast<size_t>(worker)],
+                                    file, settings);
+
+            if (error.isEmpty())
+            {
+                log("Rendered " + file.getFileName());
+            }
+            else
+            {
+                log("FAILED " + file.getFileName() + ": " + error);
+                ++numFailed;
+            }
+        });
+    }
+
+    auto startTime = juce::Time::getMillisecondCounterHiRes();
+    pool.run();
+    auto elapsedSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+
+    log(juce::String(files.size() - numFailed.load()) + "/" + juce::String(files.size())
+        + " files rendered on " + juce::String(numThreads) + " threads in "
+        + juce::String(elapsedSeconds, 2) + " s");
+
+    return numFailed.load() == 0 ? 0 : 1;
+}
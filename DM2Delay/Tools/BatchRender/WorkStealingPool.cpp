@@ -0,0 +1,74 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <thread>
+
+WorkStealingPool::WorkStealingPool(int numWorkers)
+{
+    for (int i = 0; i < std::max(1, numWorkers); ++i)
+        queues.push_back(std::make_unique<WorkerQueue>());
+}
+
+void WorkStealingPool::addJob(Job job)
+{
+    auto& queue = *queues[nextQueue];
+    nextQueue = (nextQueue + 1) % queues.size();
+
+    std::lock_guard<std::mutex> guard(queue.lock);
+    queue.jobs.push_back(std::move(job));
+}
+
+void WorkStealingPool::run()
+{
+    std::vector<std::thread> workers;
+
+    // The calling thread works too, as worker 0
+    for (int i = 1; i < getNumWorkers(); ++i)
+        workers.emplace_back([this, i] { workerLoop(i); });
+
+    workerLoop(0);
+
+    for (auto& worker : workers)
+        worker.join();
+}
+
+bool WorkStealingPool::popLocal(int workerIndex, Job& job)
+{
+    auto& queue = *queues[static_cast<size_t>(workerIndex)];
+    std::lock_guard<std::mutex> guard(queue.lock);
+
+    if (queue.jobs.empty())
+        return false;
+
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(int thiefIndex, Job& job)
+{
+    const int numWorkers = getNumWorkers();
+
+    // Start with the neighbour so thieves spread out instead of all hitting worker 0
+    for (int offset = 1; offset < numWorkers; ++offset)
+    {
+        auto& victim = *queues[static_cast<size_t>((thiefIndex + offset) % numWorkers)];
+        std::lock_guard<std::mutex> guard(victim.lock);
+
+        if (! victim.jobs.empty())
+        {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void WorkStealingPool::workerLoop(int workerIndex)
+{
+    // No jobs are added while running, so once nothing is left to steal we're done
+    Job job;
+    while (popLocal(workerIndex, job) || steal(workerIndex, job))
+        job(workerIndex);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * WorkStealingPool - Runs a fixed batch of jobs across worker threads
+ * Each worker drains its own queue from the back and, once empty, steals
+ * from the front of the other workers' queues, so long files on one worker
+ * never leave the others idle.
+ */
+class WorkStealingPool
+{
+public:
+    /** A job receives the index of the worker running it (0 to numWorkers - 1) */
+    using Job = std::function<void(int workerIndex)>;
+
+    explicit WorkStealingPool(int numWorkers);
+    ~WorkStealingPool() = default;
+
+    /** Queue a job before calling run(); jobs are dealt to workers round-robin */
+    void addJob(Job job);
+
+    /** Run every queued job and return once all of them have finished */
+    void run();
+
+    int getNumWorkers() const { return static_cast<int>(queues.size()); }
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex lock;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    size_t nextQueue = 0;
+
+    /** Take the most recently queued job from a worker's own queue */
+    bool popLocal(int workerIndex, Job& job);
+
+    /** Take the oldest job from any other worker's queue */
+    bool steal(int thiefIndex, Job& job);
+
+    void workerLoop(int workerIndex);
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+};
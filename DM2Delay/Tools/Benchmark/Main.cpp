@@ -0,0 +1,441 @@
+#include <juce_audio_utils/juce_audio_utils.h>
+#include "PluginProcessor.h"
+#include <iostream>
+
+/**
+ * DM2DelayBenchmark - Microbenchmarks for each DSP module and the full chain
+ * Sweeps sample rate, block size and parameter scenario, reports ns/sample,
+ * samples/second and single-core load as JSON, and optionally compares the
+ * results against a stored baseline.
+ *
+ * Module benchmarks use the same SIMD-lane modules as the plugin, so one
+ * "sample" is one frame carrying every channel (stereo here).
+ */
+namespace
+{
+    using SIMDSample = LaneOps::FloatVector;
+    constexpr int numBenchmarkChannels = 2;
+
+    struct Scenario
+    {
+        const char* name;
+        float delayTime;
+        float feedback;
+        float tone;
+        float mix;
+        float modulation;
+        bool sweepTone; // move tone every block (exercises coefficient updates)
+    };
+
+    const Scenario scenarios[] =
+    {
+        { "default",      Parameters::delayTimeDefault, Parameters::feedbackDefault, Parameters::toneDefault, Parameters::mixDefault, 0.0f, false },
+        { "highFeedback", Parameters::delayTimeDefault, Parameters::feedbackMax,     Parameters::toneDefault, Parameters::mixDefault, 0.0f, false },
+        { "extremeTone",  Parameters::delayTimeDefault, Parameters::feedbackDefault, Parameters::toneMin,     Parameters::mixDefault, 0.0f, false },
+        { "toneSweep",    Parameters::delayTimeDefault, Parameters::feedbackDefault, Parameters::toneDefault, Parameters::mixDefault, 0.0f, true  },
+        { "longDelay",    Parameters::delayTimeLongMax, Parameters::feedbackDefault, Parameters::toneDefault, Parameters::mixDefault, 0.0f, false },
+        { "modulated",    Parameters::delayTimeDefault, Parameters::feedbackDefault, Parameters::toneDefault, Parameters::mixDefault, 5.0f, false },
+    };
+
+    struct Options
+    {
+        juce::Array<double> sampleRates { 44100.0, 48000.0, 96000.0, 192000.0 };
+        juce::Array<int> blockSizes { 16, 64, 256, 1024, 4096 };
+        juce::StringArray benchmarks;   // empty: all
+        double secondsPerRun = 1.0;     // audio rendered per timed run
+        int repeats = 3;                // best of N
+    };
+
+    /** Tone value for a block, either fixed or swept back and forth */
+    float toneForBlock(const Scenario& scenario, int blockIndex)
+    {
+        if (! scenario.sweepTone)
+            return scenario.tone;
+
+        const int step = blockIndex % 200;
+        return static_cast<float>(step < 100 ? step : 200 - step);
+    }
+
+    /** Guitar-ish test signal: decaying plucks over a quiet noise bed */
+    void fillTestSignal(juce::AudioBuffer<float>& buffer, double sampleRate)
+    {
+        juce::Random random(1234);
+        const int pluckLength = static_cast<int>(sampleRate * 0.25);
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            auto* data = buffer.getWritePointer(channel);
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                const float envelope = std::exp(-6.0f * static_cast<float>(i % pluckLength) / static_cast<float>(pluckLength));
+                const float tone = std::sin(juce::MathConstants<float>::twoPi * 196.0f * static_cast<float>(i / sampleRate));
+                data[i] = 0.6f * envelope * tone + 0.01f * (random.nextFloat() * 2.0f - 1.0f);
+            }
+        }
+    }
+
+    /** Interleave a test buffer into SIMD frames, one channel per lane */
+    std::vector<SIMDSample> makeFrames(const juce::AudioBuffer<float>& buffer)
+    {
+        std::vector<SIMDSample> frames(static_cast<size_t>(buffer.getNumSamples()), LaneOps::broadcast<SIMDSample>(0.0f));
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                frames[static_cast<size_t>(i)].set(static_cast<size_t>(channel), buffer.getSample(channel, i));
+        return frames;
+    }
+
+    /**
+     * Time processBlock(start, numSamples, blockIndex) over the whole run, best of N
+     * @return Seconds for one full run
+     */
+    template <typename ProcessFunction>
+    double timeRuns(int totalSamples, int blockSize, int repeats, ProcessFunction&& processBlock)
+    {
+        auto runOnce = [&]
+        {
+            int blockIndex = 0;
+            for (int start = 0; start < totalSamples; start += blockSize)
+                processBlock(start, juce::jmin(blockSize, totalSamples - start), blockIndex++);
+        };
+
+        runOnce(); // warm-up: page in buffers, settle caches and branch predictors
+
+        double best = std::numeric_limits<double>::max();
+        for (int r = 0; r < repeats; ++r)
+        {
+            const auto startTicks = juce::Time::getHighResolutionTicks();
+            runOnce();
+            best = juce::jmin(best, juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks));
+        }
+
+        return best;
+    }
+
+    /** Time one of the individual DSP modules */
+    double benchmarkModule(const juce::String& name, const Scenario& scenario, double sampleRate,
+                           int blockSize, const std::vector<SIMDSample>& input, int repeats)
+    {
+        const int totalSamples = static_cast<int>(input.size());
+        std::vector<SIMDSample> output(input.size(), LaneOps::broadcast<SIMDSample>(0.0f));
+        const SIMDSample* in = input.data();
+        SIMDSample* out = output.data();
+
+        if (name == "DelayLine" || name == "DelayLineFloat")
+        {
+            DelayLine<SIMDSample> delayLine;
+            delayLine.setStorage(name == "DelayLine" ? DelayLine<SIMDSample>::Storage::int16
+                                                     : DelayLine<SIMDSample>::Storage::float32);
+            delayLine.prepare(sampleRate, blockSize, Parameters::delayTimeLongMax);
+            return timeRuns(totalSamples, blockSize, repeats, [&](int start, int n, int)
+            {
+                delayLine.processBlock(in + start, out + start, n, Parameters::toDelaySamples(scenario.delayTime, sampleRate),
+                                       Parameters::toFeedbackGain(scenario.feedback), scenario.modulation);
+            });
+        }
+
+        if (name == "BBDLine")
+        {
+            BBDLine<SIMDSample> bbdLine;
+            bbdLine.prepare(sampleRate, blockSize);
+            return timeRuns(totalSamples, blockSize, repeats, [&](int start, int n, int)
+            {
+                bbdLine.processBlock(in + start, out + start, n, scenario.delayTime,
+                                     Parameters::toFeedbackGain(scenario.feedback), scenario.modulation);
+            });
+        }
+
+        if (name == "Compander")
+        {
+            Compander<SIMDSample> compander;
+            compander.prepare(sampleRate);
+            return timeRuns(totalSamples, blockSize, repeats, [&](int start, int n, int)
+            {
+                compander.compressBlock(in + start, out + start, n);
+                compander.expandBlock(out + start, out + start, n);
+            });
+        }
+
+        if (name == "BBDModel")
+        {
+            BBDModel<SIMDSample> bbdModel;
+            bbdModel.prepare(sampleRate, blockSize);
+            return timeRuns(totalSamples, blockSize, repeats, [&](int start, int n, int)
+            {
+                bbdModel.processBlock(in + start, out + start, n, scenario.delayTime);
+            });
+        }
+
+        if (name == "Filter")
+        {
+            Filter<SIMDSample> filter;
+            filter.prepare(sampleRate);
+            return timeRuns(totalSamples, blockSize, repeats, [&](int start, int n, int blockIndex)
+            {
+                filter.processBlock(in + start, out + start, n, toneForBlock(scenario, blockIndex));
+            });
+        }
+
+        if (name == "MixStage")
+        {
+            MixStage<SIMDSample> mixStage;
+            mixStage.prepare(sampleRate);
+            return timeRuns(totalSamples, blockSize, repeats, [&](int start, int n, int)
+            {
+                mixStage.processBlock(in + start, in + start, out + start, n, Parameters::toMixLevel(scenario.mix));
+            });
+        }
+
+        // Saturation kernels alone, driven 4x harder than the test signal so most values curve
+        if (name == "SoftClip" || name == "SoftClipADAA" || name == "StdTanh")
+        {
+            std::vector<SIMDSample> driven(input.size());
+            for (size_t i = 0; i < input.size(); ++i)
+                driven[i] = input[i] * 4.0f;
+
+            const bool fastKernel = name == "SoftClip";
+            const bool adaaKernel = name == "SoftClipADAA";
+            SoftClip::TanhADAA<SIMDSample> adaa;
+
+            return timeRuns(totalSamples, blockSize, repeats, [&](int start, int n, int)
+            {
+                std::copy(driven.data() + start, driven.data() + start + n, out + start);
+
+                if (fastKernel)
+                    SoftClip::tanhBlock(out + start, n);
+                else if (adaaKernel)
+                    adaa.processBlock(out + start, n);
+                else
+                    for (int i = start; i < start + n; ++i)
+                        out[i] = LaneOps::map(out[i], [](float x) { return std::tanh(x); });
+            });
+        }
+
+        jassertfalse;
+        return 0.0;
+    }
+
+    void setParameter(DM2DelayAudioProcessor& processor, const juce::String& parameterID, float value)
+    {
+        if (auto* parameter = processor.getAPVTS().getParameter(parameterID))
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    /** Time the complete processor in Standard or Custom mode */
+    double benchmarkChain(bool customMode, const Scenario& scenario, double sampleRate,
+                          int blockSize, const juce::AudioBuffer<float>& input, int repeats)
+    {
+        DM2DelayAudioProcessor processor;
+
+        setParameter(processor, Parameters::modeID, customMode ? 1.0f : 0.0f);
+        // Beyond the pedal's range the delay comes from the long delay parameters
+        const bool longDelay = scenario.delayTime > Parameters::delayTimeMax;
+        setParameter(processor, Parameters::longDelayID, longDelay ? 1.0f : 0.0f);
+        setParameter(processor, Parameters::delayTimeLongID, scenario.delayTime);
+        setParameter(processor, Parameters::delayTimeLong2ID, scenario.delayTime);
+        setParameter(processor, Parameters::delayTimeID, scenario.delayTime);
+        setParameter(processor, Parameters::feedbackID, scenario.feedback);
+        setParameter(processor, Parameters::toneID, scenario.tone);
+        setParameter(processor, Parameters::mixID, scenario.mix);
+        setParameter(processor, Parameters::modulationID, scenario.modulation);
+        setParameter(processor, Parameters::delayTime2ID, scenario.delayTime);
+        setParameter(processor, Parameters::feedback2ID, scenario.feedback);
+        setParameter(processor, Parameters::tone2ID, scenario.tone);
+        setParameter(processor, Parameters::mix2ID, scenario.mix);
+        setParameter(processor, Parameters::modulation2ID, scenario.modulation);
+
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> block(input.getNumChannels(), blockSize);
+        juce::MidiBuffer midi;
+
+        return timeRuns(input.getNumSamples(), blockSize, repeats, [&](int start, int n, int blockIndex)
+        {
+            if (scenario.sweepTone)
+            {
+                const float tone = toneForBlock(scenario, blockIndex);
+                setParameter(processor, Parameters::toneID, tone);
+                setParameter(processor, Parameters::tone2ID, tone);
+            }
+
+            block.setSize(input.getNumChannels(), n, false, false, true);
+            for (int channel = 0; channel < input.getNumChannels(); ++channel)
+                block.copyFrom(channel, 0, input, channel, start, n);
+
+            processor.processBlock(block, midi);
+        });
+    }
+
+    juce::String resultKey(const juce::var& result)
+    {
+        return result["benchmark"].toString() + "/" + result["scenario"].toString() + "/"
+             + result["sampleRate"].toString() + "/" + result["blockSize"].toString();
+    }
+
+    /** Print regressions against a baseline; returns the number of regressions */
+    int compareWithBaseline(const juce::Array<juce::var>& results, const juce::var& baseline, double tolerance)
+    {
+        std::map<juce::String, double> baselineNs;
+        if (auto* baselineResults = baseline["results"].getArray())
+            for (auto& result : *baselineResults)
+                baselineNs[resultKey(result)] = static_cast<double>(result["nsPerSample"]);
+
+        int numRegressions = 0;
+        for (auto& result : results)
+        {
+            auto match = baselineNs.find(resultKey(result));
+            if (match == baselineNs.end() || match->second <= 0.0)
+                continue;
+
+            const double change = static_cast<double>(result["nsPerSample"]) / match->second - 1.0;
+            if (change > tolerance)
+            {
+                std::cerr << "REGRESSION " << resultKey(result) << ": "
+                          << juce::String(match->second, 2) << " -> "
+                          << juce::String(static_cast<double>(result["nsPerSample"]), 2) << " ns/sample (+"
+                          << juce::String(change * 100.0, 1) << "%)" << std::endl;
+                ++numRegressions;
+            }
+        }
+
+        return numRegressions;
+    }
+
+    void printUsage()
+    {
+        std::cout
+            << "Usage: DM2DelayBenchmark [options]\n"
+            << "\n"
+            << "Options:\n"
+            << "  --rates=<list>       Sample rates, e.g. 44100,48000,96000,192000\n"
+            << "  --blocks=<list>      Block sizes, e.g. 16,64,256,1024,4096\n"
+            << "  --only=<list>        Benchmarks to run (DelayLine,DelayLineFloat,BBDLine,Compander,\n"
+            << "                       BBDModel,Filter,MixStage,SoftClip,SoftClipADAA,StdTanh,\n"
+            << "                       StandardChain,CustomChain)\n"
+            << "  --seconds=<s>        Audio rendered per timed run (default: 1)\n"
+            << "  --repeats=<n>        Timed runs per case, best is kept (default: 3)\n"
+            << "  --output=<file>      Write JSON results to a file instead of stdout\n"
+            << "  --baseline=<file>    Compare against a previous JSON result\n"
+            << "  --tolerance=<pct>    Allowed slowdown before a case counts as a regression (default: 10)\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    // APVTS needs a message manager; the main thread plays that role but never dispatches
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    Options options;
+
+    if (args.containsOption("--rates"))
+    {
+        options.sampleRates.clear();
+        for (auto& rate : juce::StringArray::fromTokens(args.getValueForOption("--rates"), ",", {}))
+            options.sampleRates.add(rate.getDoubleValue());
+    }
+
+    if (args.containsOption("--blocks"))
+    {
+        options.blockSizes.clear();
+        for (auto& size : juce::StringArray::fromTokens(args.getValueForOption("--blocks"), ",", {}))
+            options.blockSizes.add(juce::jmax(1, size.getIntValue()));
+    }
+
+    if (args.containsOption("--only"))
+        options.benchmarks = juce::StringArray::fromTokens(args.getValueForOption("--only"), ",", {});
+
+    if (args.containsOption("--seconds"))
+        options.secondsPerRun = juce::jmax(0.01, args.getValueForOption("--seconds").getDoubleValue());
+
+    if (args.containsOption("--repeats"))
+        options.repeats = juce::jmax(1, args.getValueForOption("--repeats").getIntValue());
+
+    const juce::StringArray allBenchmarks { "DelayLine", "DelayLineFloat", "BBDLine", "Compander", "BBDModel",
+                                            "Filter", "MixStage", "SoftClip", "SoftClipADAA", "StdTanh",
+                                            "StandardChain", "CustomChain" };
+
+    juce::Array<juce::var> results;
+
+    for (auto& benchmark : allBenchmarks)
+    {
+        if (! options.benchmarks.isEmpty() && ! options.benchmarks.contains(benchmark))
+            continue;
+
+        for (auto sampleRate : options.sampleRates)
+        {
+            const int totalSamples = static_cast<int>(sampleRate * options.secondsPerRun);
+
+            juce::AudioBuffer<float> input(numBenchmarkChannels, totalSamples);
+            fillTestSignal(input, sampleRate);
+            const auto frames = makeFrames(input);
+
+            for (auto blockSize : options.blockSizes)
+            {
+                for (auto& scenario : scenarios)
+                {
+                    double seconds = 0.0;
+
+                    if (benchmark == "StandardChain" || benchmark == "CustomChain")
+                        seconds = benchmarkChain(benchmark == "CustomChain", scenario, sampleRate,
+                                                 blockSize, input, options.repeats);
+                    else
+                        seconds = benchmarkModule(benchmark, scenario, sampleRate, blockSize, frames, options.repeats);
+
+                    auto* result = new juce::DynamicObject();
+                    result->setProperty("benchmark", benchmark);
+                    result->setProperty("scenario", scenario.name);
+                    result->setProperty("sampleRate", sampleRate);
+                    result->setProperty("blockSize", blockSize);
+                    result->setProperty("nsPerSample", seconds * 1.0e9 / totalSamples);
+                    result->setProperty("samplesPerSecond", totalSamples / seconds);
+                    result->setProperty("cpuPercent", 100.0 * seconds / options.secondsPerRun); // of one core, realtime
+                    results.add(juce::var(result));
+
+                    std::cerr << benchmark << " " << scenario.name << " " << sampleRate << " Hz, block "
+                              << blockSize << ": " << juce::String(seconds * 1.0e9 / totalSamples, 2)
+                              << " ns/sample" << std::endl;
+                }
+            }
+        }
+    }
+
+    auto* report = new juce::DynamicObject();
+    report->setProperty("channels", numBenchmarkChannels);
+    report->setProperty("simdLanes", static_cast<int>(LaneOps::numLanes<SIMDSample>()));
+    report->setProperty("results", results);
+    auto json = juce::JSON::toString(juce::var(report));
+
+    if (args.containsOption("--output"))
+        juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output")).replaceWithText(json);
+    else
+        std::cout << json << std::endl;
+
+    if (args.containsOption("--baseline"))
+    {
+        auto baselineFile = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--baseline"));
+        auto baseline = juce::JSON::parse(baselineFile);
+
+        if (! baseline.isObject())
+        {
+            std::cerr << "Can't read baseline: " << baselineFile.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        const double tolerance = (args.containsOption("--tolerance")
+                                      ? args.getValueForOption("--tolerance").getDoubleValue()
+                                      : 10.0) / 100.0;
+
+        if (compareWithBaseline(results, baseline, tolerance) > 0)
+            return 1;
+    }
+
+    return 0;
+}
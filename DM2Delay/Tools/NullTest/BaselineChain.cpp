@@ -0,0 +1,224 @@
+#include "BaselineChain.h"
+#include "DSP/DelayLine.h"
+#include "DSP/ModulationLFO.h"
+#include <cmath>
+#include <memory>
+
+namespace Baseline
+{
+    namespace
+    {
+        // Compander: threshold at -20 dB, 2:1, gain limited to 0.1-3
+        constexpr float threshold = 0.1f;
+        constexpr float ratio = 2.0f;
+
+        // Samples per LFO control step (the delay ramps across each)
+        constexpr int controlInterval = ModulationLFO<float>::controlInterval;
+
+        // First-order ADAA averages across one sample, so it lags by half of one
+        constexpr double saturationLatencySamples = 0.5;
+
+        // The plugin's filters are exact Butterworth (the baseline's Q was 0.707)
+        constexpr float butterworthQ = 0.70710678f;
+
+        /** log(cosh(x)), the antiderivative of tanh */
+        double logCosh(double x)
+        {
+            const double magnitude = std::abs(x);
+            return magnitude + std::log1p(std::exp(-2.0 * magnitude)) - std::log(2.0);
+        }
+    }
+
+    Stage::Stage(double sampleRate, const StageSettings& settings, juce::uint32 noiseSeed, double lfoPhase)
+        : currentSampleRate(sampleRate)
+        , feedbackGain(juce::jlimit(0.0f, 0.95f, settings.feedback / 100.0f))
+        , mixLevel(juce::jlimit(0.0f, 100.0f, settings.mix) / 100.0f)
+        , lfoOffset(lfoPhase)
+    {
+        // Attack 1 ms, release 50 ms
+        attackCoeff = 1.0f - std::exp(-1.0f / (1.0f * 0.001f * static_cast<float>(sampleRate)));
+        releaseCoeff = 1.0f - std::exp(-1.0f / (50.0f * 0.001f * static_cast<float>(sampleRate)));
+
+        // Delay in samples as the baseline converted it (in float); the saturation's
+        // latency comes off it, so the echoes stay on the beat
+        const float delaySamples = (settings.delayTime / 1000.0f) * static_cast<float>(sampleRate);
+        baseDelay = delaySamples - saturationLatencySamples;
+        depth = ModulationLFO<float>::getDepthMs(settings.modulation) * 0.001 * sampleRate;
+        depthCoeff = 1.0 - std::exp(-controlInterval / (DelayLine<float>::delaySmoothingMs * 0.001 * sampleRate));
+        lfoStep = juce::MathConstants<double>::twoPi * settings.modulation * controlInterval / sampleRate;
+
+        startDelay = baseDelay;
+        endDelay = baseDelay;
+        intervalPosition = controlInterval;
+
+        // Room for the deepest wobble and the interpolation taps
+        ring.assign(static_cast<size_t>(std::ceil(baseDelay + depth)) + 4, 0.0f);
+
+        // Noise floor: -60 dB, up to -54 dB at 300 ms, then 3 dB per doubling
+        const float noiseDelayTimeMs = settings.delayTime - static_cast<float>(1000.0 * saturationLatencySamples / sampleRate);
+        float noiseDB = -60.0f + juce::jmin(noiseDelayTimeMs, 300.0f) / 300.0f * 6.0f;
+
+        if (noiseDelayTimeMs > 300.0f)
+            noiseDB += 3.0f * std::log2(noiseDelayTimeMs / 300.0f);
+
+        noiseAmplitude = std::pow(10.0f, noiseDB / 20.0f);
+        noise.setSeed(noiseSeed);
+
+        // Tone maps 0-100% to a 3-8 kHz cutoff
+        const float toneCutoff = 3000.0f + juce::jlimit(0.0f, 100.0f, settings.tone) / 100.0f * 5000.0f;
+        bbdLowpass.coefficients = juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, 5000.0f, butterworthQ);
+        toneLowpass.coefficients = juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, toneCutoff, butterworthQ);
+
+        // Mix smoothing: 5 ms
+        mixSmoothingCoeff = 1.0f - std::exp(-1.0f / (5.0f * 0.001f * static_cast<float>(sampleRate)));
+    }
+
+    float Stage::updateEnvelope(float inputLevel, float currentEnvelope) const
+    {
+        const float absLevel = std::abs(inputLevel);
+        const float coeff = absLevel > currentEnvelope ? attackCoeff : releaseCoeff;
+        return currentEnvelope + coeff * (absLevel - currentEnvelope);
+    }
+
+    float Stage::computeGain(float envelope, bool isCompression)
+    {
+        if (envelope < threshold)
+            return 1.0f;
+
+        const float envDB = 20.0f * std::log10(envelope + 1e-6f);
+        const float thresholdDB = 20.0f * std::log10(threshold);
+
+        const float gainChangeDB = isCompression ? -(envDB - thresholdDB) * (1.0f - 1.0f / ratio)
+                                                 : (envDB - thresholdDB) * (ratio - 1.0f);
+
+        return juce::jlimit(0.1f, 3.0f, std::pow(10.0f, gainChangeDB / 20.0f));
+    }
+
+    void Stage::beginControlInterval()
+    {
+        smoothedDepth += (depth - smoothedDepth) * depthCoeff;
+        if (std::abs(depth - smoothedDepth) < 1.0e-3)
+            smoothedDepth = depth;
+
+        // The LFO only turns while there is depth to apply
+        if (smoothedDepth > 0.0)
+            lfoPhase += lfoStep;
+
+        startDelay = endDelay;
+        endDelay = juce::jmax(1.0, baseDelay + smoothedDepth * std::sin(lfoPhase + lfoOffset));
+        intervalPosition = 0;
+    }
+
+    float Stage::readInterpolated(double delaySamples) const
+    {
+        const int size = static_cast<int>(ring.size());
+
+        double readPos = static_cast<double>(writeIndex) - delaySamples;
+        while (readPos < 0.0)
+            readPos += size;
+
+        const int index0 = static_cast<int>(std::floor(readPos)) % size;
+        const float frac = static_cast<float>(readPos - std::floor(readPos));
+
+        const float y0 = ring[static_cast<size_t>((index0 - 1 + size) % size)];
+        const float y1 = ring[static_cast<size_t>(index0)];
+        const float y2 = ring[static_cast<size_t>((index0 + 1) % size)];
+        const float y3 = ring[static_cast<size_t>((index0 + 2) % size)];
+
+        const float c0 = y1;
+        const float c1 = 0.5f * (y2 - y0);
+        const float c2 = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
+        const float c3 = 0.5f * (y3 - y0) + 1.5f * (y1 - y2);
+
+        return ((c3 * frac + c2) * frac + c1) * frac + c0;
+    }
+
+    float Stage::processDelay(float input)
+    {
+        if (intervalPosition == controlInterval)
+            beginControlInterval();
+
+        ++intervalPosition;
+        const double delay = startDelay + (endDelay - startDelay) * intervalPosition / controlInterval;
+        const float delayed = readInterpolated(delay);
+
+        // Soft clip the feedback, then what is written
+        ring[static_cast<size_t>(writeIndex)] = std::tanh(input + std::tanh(delayed * feedbackGain));
+        writeIndex = (writeIndex + 1) % static_cast<int>(ring.size());
+
+        return delayed;
+    }
+
+    float Stage::processBBD(float input)
+    {
+        // Subtle 12-bit quantisation, mostly the original
+        const float steps = 4096.0f;
+        const float quantized = std::round(input * steps) / steps;
+        float sample = input * 0.95f + quantized * 0.05f;
+
+        sample += noise.getNextSample(noiseAmplitude);
+
+        // tanh(0.9x) * 1.1, first-order ADAA in double; tanh of the midpoint
+        // where successive inputs are too close for the difference
+        const double scaled = 0.9 * sample;
+        const double step = scaled - lastSaturationInput;
+        const double saturated = std::abs(step) < 1.0e-6 ? std::tanh(0.5 * (scaled + lastSaturationInput))
+                                                         : (logCosh(scaled) - logCosh(lastSaturationInput)) / step;
+        lastSaturationInput = scaled;
+
+        return static_cast<float>(1.1 * saturated);
+    }
+
+    float Stage::processSample(float input)
+    {
+        const float drySample = input;
+
+        compressEnvelope = updateEnvelope(input, compressEnvelope);
+        float sample = input * computeGain(compressEnvelope, true);
+
+        sample = processDelay(sample);
+        sample = processBBD(sample);
+
+        expandEnvelope = updateEnvelope(sample, expandEnvelope);
+        sample *= computeGain(expandEnvelope, false);
+
+        sample = toneLowpass.processSample(bbdLowpass.processSample(sample));
+
+        smoothedMix += mixSmoothingCoeff * (mixLevel - smoothedMix);
+        const float wetGain = std::sin(smoothedMix * juce::MathConstants<float>::halfPi);
+        const float dryGain = std::cos(smoothedMix * juce::MathConstants<float>::halfPi);
+
+        return drySample * dryGain + sample * wetGain;
+    }
+
+    juce::AudioBuffer<float> render(const juce::AudioBuffer<float>& input, double sampleRate,
+                                    const StageSettings* stages, int numStages, juce::uint32 noiseSeed)
+    {
+        juce::AudioBuffer<float> output(input);
+
+        for (int channel = 0; channel < output.getNumChannels(); ++channel)
+        {
+            // Stage k's seed is noiseSeed + k, spread across lanes as the plugin does;
+            // neighbouring channels wobble a quarter cycle apart
+            std::vector<std::unique_ptr<Stage>> chain;
+            for (int stage = 0; stage < numStages; ++stage)
+                chain.push_back(std::make_unique<Stage>(
+                    sampleRate, stages[stage],
+                    NoiseGenerator<float>::getLaneSeed(noiseSeed + static_cast<juce::uint32>(stage), static_cast<size_t>(channel)),
+                    juce::MathConstants<double>::halfPi * channel));
+
+            auto* data = output.getWritePointer(channel);
+            for (int i = 0; i < output.getNumSamples(); ++i)
+            {
+                float sample = data[i];
+                for (auto& stage : chain)
+                    sample = stage->processSample(sample);
+
+                // Output soft clip
+                data[i] = std::tanh(sample);
+            }
+        }
+
+        return output;
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+#include "DSP/NoiseGenerator.h"
+
+/**
+ * Baseline - The DM-2 ring buffer chain as plain per-sample code
+ * The stage modules as they were before the performance work: one sample at
+ * a time through each module, std::tanh clippers, the dB-domain compander
+ * gain computer, equal-power gains computed per sample, a modulo-wrapped ring
+ * read at a double-precision position, and RBJ biquads for the filters.
+ *
+ * On top of that it carries the deliberate changes to the sound made since:
+ * the modulation LFO (ramped across control steps, depth fading in), the
+ * seeded noise stream, the extended noise floor and the ADAA BBD saturation
+ * with its half sample taken off the delay.
+ *
+ * A diagnostic only (DM2DelayNullTest --baseline): it is written by hand to
+ * follow the plugin, so it can't prove a change safe. The stored references
+ * are the pass/fail source; when one of those nulls fails, this tells a
+ * rounding difference in an optimised module from a change in what a module
+ * does. Only the ring buffer engine in series is modelled: the clocked
+ * engine and parallel routing have no baseline.
+ */
+namespace Baseline
+{
+    /** One stage's controls, in parameter units, held for the whole render */
+    struct StageSettings
+    {
+        float delayTime;    // ms
+        float feedback;     // %
+        float mix;          // %
+        float tone;         // %
+        float modulation;   // Hz
+    };
+
+    /** One stage for one channel: compander, delay, BBD artifacts, filters and mix */
+    class Stage
+    {
+    public:
+        /**
+         * @param noiseSeed Seed of this stage's noise stream on this channel
+         * @param lfoPhase Phase offset of this channel's wobble, in radians
+         */
+        Stage(double sampleRate, const StageSettings& settings, juce::uint32 noiseSeed, double lfoPhase);
+        ~Stage() = default;
+
+        /** Process one sample; the stage input is also the dry signal of its mix */
+        float processSample(float input);
+
+    private:
+        double currentSampleRate;
+
+        float feedbackGain;
+        float mixLevel;
+
+        // Compander
+        float attackCoeff;
+        float releaseCoeff;
+        float compressEnvelope = 0.0f;
+        float expandEnvelope = 0.0f;
+
+        // Delay ring, written one sample at a time
+        std::vector<float> ring;
+        int writeIndex = 0;
+
+        // Delay per sample: ramped linearly to the wobbled delay across each control step
+        double baseDelay;
+        double depth;
+        double smoothedDepth = 0.0;
+        double depthCoeff;
+        double lfoPhase = 0.0;
+        double lfoStep;
+        double lfoOffset;
+        double startDelay;
+        double endDelay;
+        int intervalPosition;
+
+        // BBD artifacts
+        NoiseGenerator<float> noise;
+        float noiseAmplitude;
+        double lastSaturationInput = 0.0;
+
+        // Fixed 5 kHz BBD lowpass, then the tone control
+        juce::dsp::IIR::Filter<float> bbdLowpass;
+        juce::dsp::IIR::Filter<float> toneLowpass;
+
+        // Mix position, glides from dry
+        float smoothedMix = 0.0f;
+        float mixSmoothingCoeff;
+
+        float updateEnvelope(float inputLevel, float currentEnvelope) const;
+        static float computeGain(float envelope, bool isCompression);
+
+        /** Read, apply feedback and write one sample */
+        float processDelay(float input);
+
+        /** Step the depth glide and the LFO, and set the delay the next control step ramps to */
+        void beginControlInterval();
+
+        /** 4-point cubic (Hermite) read, delaySamples behind the write position */
+        float readInterpolated(double delaySamples) const;
+
+        /** Sample-and-hold character, noise and the ADAA saturation */
+        float processBBD(float input);
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Stage)
+    };
+
+    /**
+     * Render a buffer through numStages stages in series (stage 2 mixes against
+     * stage 1's output, as in custom mode), then the output soft clip
+     * Channel c gets the noise stream and wobble phase of the plugin's SIMD lane c
+     */
+    juce::AudioBuffer<float> render(const juce::AudioBuffer<float>& input, double sampleRate,
+                                    const StageSettings* stages, int numStages, juce::uint32 noiseSeed);
+}
@@ -0,0 +1,712 @@
+#include <juce_audio_utils/juce_audio_utils.h>
+#include <juce_dsp/juce_dsp.h>
+#include "PluginProcessor.h"
+#include "BaselineChain.h"
+#include <iostream>
+
+#ifndef DM2DELAY_NULLTEST_REFERENCES
+ #define DM2DELAY_NULLTEST_REFERENCES "NullTestReferences"
+#endif
+
+/**
+ * DM2DelayNullTest - Golden-output regression and null tests
+ * Renders fixed test signals (impulse, sine burst, log sweep, guitar-like
+ * plucks) through the Standard, Custom and Custom clocked-parallel chains
+ * with the BBD noise seeded, and compares each render against a stored reference (32-bit float WAV,
+ * committed under References): max error, RMS error relative to the
+ * reference (null depth) and the largest third-octave band level difference,
+ * each against a per-case tolerance. A missing reference fails the run, and
+ * is reported as missing rather than as a difference in the sound.
+ *
+ * It also sweeps the compander's closed-form gain computer (scalar and SIMD
+ * builds) against its dB-domain reference.
+ *
+ * With --variant the tool compares two implementations against each other
+ * instead of against stored files: the SIMD stage graph against the scalar
+ * (float) graph lane by lane, or 16-bit delay storage against float storage.
+ * With --baseline it nulls the ring buffer chains against the plain
+ * per-sample chain in BaselineChain.h, to help tell an optimisation's
+ * rounding from a change in a module when a reference comparison fails.
+ *
+ * Exit code 0 means every case that ran is within tolerance and had its
+ * reference.
+ */
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 256;
+    constexpr int numChannels = 2;
+    constexpr double renderSeconds = 1.5;
+    constexpr juce::uint32 noiseSeed = 2024;
+
+    // Bands more than this far below the loudest one are noise floor and don't count
+    constexpr double spectralRangeDb = 60.0;
+    constexpr int fftOrder = 12;
+
+    enum class Signal
+    {
+        impulse,
+        sine,
+        sweep,
+        plucks
+    };
+
+    struct Chain
+    {
+        bool customMode;
+        bool clockedEngine;
+        bool parallelRouting;
+    };
+
+    const Chain standardChain { false, false, false };
+    const Chain customChain { true, false, false };
+    const Chain clockedParallelChain { true, true, true };
+
+    struct Tolerance
+    {
+        float maxErrorDb;   // largest sample difference, dBFS
+        float rmsErrorDb;   // RMS of the difference relative to the reference's RMS
+        float spectralDb;   // largest third-octave band level difference
+    };
+
+    // The ring buffer chains are plain arithmetic; the clocked engine resamples through a
+    // modulated clock, which turns rounding differences into small timing differences
+    constexpr Tolerance strict { -100.0f, -90.0f, 0.05f };
+    constexpr Tolerance regular { -80.0f, -70.0f, 0.1f };
+    constexpr Tolerance clocked { -60.0f, -50.0f, 0.25f };
+
+    // Against the baseline chain (--baseline): fast tanh, ADAA and the closed-form compander round
+    // differently, and the 12-bit sample-and-hold turns the odd rounding difference into a step
+    // the feedback repeats
+    constexpr Tolerance baselineTolerance { -70.0f, -65.0f, 0.05f };
+
+    struct TestCase
+    {
+        const char* name;
+        Signal signal;
+        const Chain& chain;
+        Tolerance tolerance;
+    };
+
+    const TestCase testCases[] =
+    {
+        { "standard-impulse",       Signal::impulse, standardChain,        strict  },
+        { "standard-sine",          Signal::sine,    standardChain,        regular },
+        { "standard-sweep",         Signal::sweep,   standardChain,        regular },
+        { "standard-plucks",        Signal::plucks,  standardChain,        regular },
+        { "custom-impulse",         Signal::impulse, customChain,          strict  },
+        { "custom-sine",            Signal::sine,    customChain,          regular },
+        { "custom-sweep",           Signal::sweep,   customChain,          regular },
+        { "custom-plucks",          Signal::plucks,  customChain,          regular },
+        { "clockedParallel-impulse", Signal::impulse, clockedParallelChain, clocked },
+        { "clockedParallel-sine",   Signal::sine,    clockedParallelChain, clocked },
+        { "clockedParallel-sweep",  Signal::sweep,   clockedParallelChain, clocked },
+        { "clockedParallel-plucks", Signal::plucks,  clockedParallelChain, clocked },
+    };
+
+    /** An alternative implementation, checked against the reference one */
+    struct Variant
+    {
+        const char* name;
+        const char* description;
+        Tolerance tolerance;
+    };
+
+    const Variant variants[] =
+    {
+        { "simd",    "SIMD stage graph vs scalar (float) graph", { -100.0f, -90.0f, 0.05f } },
+        { "compact", "16-bit delay storage vs float storage",    { -70.0f,  -50.0f, 0.05f } },
+    };
+
+    //==============================================================================
+    /** One test signal, channel 1 a quieter copy of channel 0 so the lanes differ */
+    juce::AudioBuffer<float> makeSignal(Signal signal)
+    {
+        const int numSamples = static_cast<int>(renderSeconds * sampleRate);
+        juce::AudioBuffer<float> buffer(numChannels, numSamples);
+        buffer.clear();
+
+        auto* data = buffer.getWritePointer(0);
+        const float twoPi = juce::MathConstants<float>::twoPi;
+        auto timeOf = [](int i) { return static_cast<float>(i / sampleRate); };
+
+        switch (signal)
+        {
+            case Signal::impulse:
+                data[static_cast<int>(0.05 * sampleRate)] = 1.0f;
+                break;
+
+            case Signal::sine:
+            {
+                // 440 Hz burst with 5 ms ramps, then silence for the repeats
+                const int length = static_cast<int>(0.75 * sampleRate);
+                const int ramp = static_cast<int>(0.005 * sampleRate);
+                for (int i = 0; i < length; ++i)
+                {
+                    const float gain = static_cast<float>(juce::jmin(ramp, i, length - 1 - i)) / static_cast<float>(ramp);
+                    data[i] = 0.5f * gain * std::sin(twoPi * 440.0f * timeOf(i));
+                }
+                break;
+            }
+
+            case Signal::sweep:
+            {
+                // Exponential 20 Hz - 20 kHz sweep over one second
+                const float seconds = 1.0f;
+                const float rate = std::log(20000.0f / 20.0f) / seconds;
+                for (int i = 0; i < static_cast<int>(seconds * sampleRate); ++i)
+                    data[i] = 0.25f * std::sin(twoPi * 20.0f * (std::exp(rate * timeOf(i)) - 1.0f) / rate);
+                break;
+            }
+
+            case Signal::plucks:
+            {
+                // Four plucked notes: a short noise burst, then decaying harmonics (higher ones die faster)
+                const float notes[] = { 110.0f, 146.83f, 196.0f, 246.94f };
+                const int spacing = static_cast<int>(0.25 * sampleRate);
+
+                // A fixed LCG rather than a library generator, so the stored references
+                // never depend on which JUCE version built the tool
+                juce::uint32 noiseState = 1234;
+                auto nextNoise = [&noiseState]
+                {
+                    noiseState = noiseState * 1664525u + 1013904223u;
+                    return static_cast<float>(noiseState >> 8) / 16777216.0f * 2.0f - 1.0f;
+                };
+
+                for (int note = 0; note < 4; ++note)
+                {
+                    auto* pluck = data + note * spacing;
+                    for (int i = 0; i < spacing * 2 && note * spacing + i < numSamples; ++i)
+                    {
+                        const float t = timeOf(i);
+                        float sample = t < 0.005f ? 0.3f * nextNoise() : 0.0f;
+
+                        for (int harmonic = 1; harmonic <= 6; ++harmonic)
+                        {
+                            const float h = static_cast<float>(harmonic);
+                            sample += std::exp(-3.0f * h * t) / h * std::sin(twoPi * notes[note] * h * t);
+                        }
+
+                        pluck[i] += 0.3f * sample;
+                    }
+                }
+                break;
+            }
+        }
+
+        buffer.copyFrom(1, 0, buffer, 0, 0, numSamples);
+        buffer.applyGain(1, 0, numSamples, 0.7f);
+        return buffer;
+    }
+
+    //==============================================================================
+    // Control settings shared by every chain: stage 2 differs from stage 1 so both are audible.
+    // Delay times stay within the classic 20-300 ms range, which is what the delay time parameters hold
+    const Baseline::StageSettings stageValues[Parameters::numStages] =
+    {
+        { 300.0f, 55.0f, 50.0f, 70.0f, 0.8f },
+        { 250.0f, 40.0f, 50.0f, 60.0f, 1.3f }
+    };
+
+    void setParameter(DM2DelayAudioProcessor& processor, const juce::String& parameterID, float value)
+    {
+        if (auto* parameter = processor.getAPVTS().getParameter(parameterID))
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    /** Render through the complete processor (latency, bypass and output clip included) */
+    juce::AudioBuffer<float> renderProcessor(const Chain& chain, const juce::AudioBuffer<float>& input,
+                                             bool compactDelayStorage)
+    {
+        DM2DelayAudioProcessor processor;
+        processor.setNoiseSeed(noiseSeed);
+        processor.setCompactDelayStorage(compactDelayStorage);
+
+        setParameter(processor, Parameters::modeID, chain.customMode ? 1.0f : 0.0f);
+        setParameter(processor, Parameters::engineID, chain.clockedEngine ? 1.0f : 0.0f);
+        setParameter(processor, Parameters::routingID, chain.parallelRouting ? 1.0f : 0.0f);
+
+        const juce::String stageIDs[Parameters::numStages][5] =
+        {
+            { Parameters::delayTimeID, Parameters::feedbackID, Parameters::mixID, Parameters::toneID, Parameters::modulationID },
+            { Parameters::delayTime2ID, Parameters::feedback2ID, Parameters::mix2ID, Parameters::tone2ID, Parameters::modulation2ID }
+        };
+
+        for (int stage = 0; stage < Parameters::numStages; ++stage)
+        {
+            const auto& values = stageValues[stage];
+            setParameter(processor, stageIDs[stage][0], values.delayTime);
+            setParameter(processor, stageIDs[stage][1], values.feedback);
+            setParameter(processor, stageIDs[stage][2], values.mix);
+            setParameter(processor, stageIDs[stage][3], values.tone);
+            setParameter(processor, stageIDs[stage][4], values.modulation);
+        }
+
+        processor.setNonRealtime(true);
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> output(input);
+        juce::MidiBuffer midi;
+
+        for (int start = 0; start < output.getNumSamples(); start += blockSize)
+        {
+            juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), numChannels, start,
+                                           juce::jmin(blockSize, output.getNumSamples() - start));
+            processor.processBlock(block, midi);
+        }
+
+        return output;
+    }
+
+    /** Whether the baseline chain models this chain: ring buffer engine, stages in series */
+    bool hasBaseline(const Chain& chain)
+    {
+        return ! chain.clockedEngine && ! chain.parallelRouting;
+    }
+
+    /** Render through the baseline chain (stage 2 joins in custom mode) */
+    juce::AudioBuffer<float> renderBaseline(const Chain& chain, const juce::AudioBuffer<float>& input)
+    {
+        return Baseline::render(input, sampleRate, stageValues, chain.customMode ? Parameters::numStages : 1, noiseSeed);
+    }
+
+    /**
+     * Render through a bare stage graph, the part of the chain that has a scalar and a SIMD build
+     * @param withModulation Off for lane comparisons: each lane wobbles at its own LFO phase
+     */
+    template <typename SampleType>
+    std::vector<SampleType> renderGraph(const Chain& chain, std::vector<SampleType> frames, juce::uint32 seed,
+                                        bool withModulation)
+    {
+        StageGraph<SampleType> graph;
+        graph.prepare(sampleRate, blockSize, Parameters::numStages, Parameters::delayTimeLongMax, false);
+        graph.setNoiseSeed(seed);
+
+        typename StageGraph<SampleType>::Patch patch;
+        patch.numStages = Parameters::numStages;
+        patch.routing = chain.parallelRouting ? StageGraph<SampleType>::Routing::parallel
+                                              : StageGraph<SampleType>::Routing::series;
+
+        for (int stage = 0; stage < Parameters::numStages; ++stage)
+        {
+            const auto& values = stageValues[stage];
+            auto& settings = patch.stages[static_cast<size_t>(stage)];
+            settings.enabled = stage == 0 || chain.customMode;
+            settings.clockedEngine = chain.clockedEngine;
+            settings.delayTime = values.delayTime;
+            settings.delaySamples = Parameters::toDelaySamples(values.delayTime, sampleRate);
+            settings.feedbackGain = Parameters::toFeedbackGain(values.feedback);
+            settings.modulation = withModulation ? values.modulation : 0.0f;
+            settings.tone = values.tone;
+            settings.mixLevel = Parameters::toMixLevel(values.mix);
+        }
+
+        const int numSamples = static_cast<int>(frames.size());
+        for (int start = 0; start < numSamples; start += blockSize)
+            graph.process(frames.data() + start, juce::jmin(blockSize, numSamples - start), patch);
+
+        return frames;
+    }
+
+    /**
+     * Render the SIMD graph once and the scalar graph once per lane, each lane fed
+     * a test channel and seeded to replay that lane's noise (modulation off, since
+     * the lanes' LFO phases are spread apart)
+     * @return Scalar renders and SIMD lanes, one channel per lane
+     */
+    std::pair<juce::AudioBuffer<float>, juce::AudioBuffer<float>> renderLanes(const Chain& chain,
+                                                                              const juce::AudioBuffer<float>& input)
+    {
+        using SIMDSample = LaneOps::FloatVector;
+        constexpr size_t numLanes = LaneOps::numLanes<SIMDSample>();
+        const int numSamples = input.getNumSamples();
+
+        std::vector<SIMDSample> frames(static_cast<size_t>(numSamples), LaneOps::broadcast<SIMDSample>(0.0f));
+        for (size_t lane = 0; lane < numLanes; ++lane)
+            for (int i = 0; i < numSamples; ++i)
+                frames[static_cast<size_t>(i)].set(lane, input.getSample(static_cast<int>(lane) % numChannels, i));
+
+        const auto simdFrames = renderGraph(chain, std::move(frames), noiseSeed, false);
+
+        juce::AudioBuffer<float> scalar(static_cast<int>(numLanes), numSamples);
+        juce::AudioBuffer<float> simd(static_cast<int>(numLanes), numSamples);
+
+        for (size_t lane = 0; lane < numLanes; ++lane)
+        {
+            const auto* channel = input.getReadPointer(static_cast<int>(lane) % numChannels);
+            const auto scalarFrames = renderGraph(chain, std::vector<float>(channel, channel + numSamples),
+                                                  NoiseGenerator<float>::getLaneSeed(noiseSeed, lane), false);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                scalar.setSample(static_cast<int>(lane), i, scalarFrames[static_cast<size_t>(i)]);
+                simd.setSample(static_cast<int>(lane), i, simdFrames[static_cast<size_t>(i)].get(lane));
+            }
+        }
+
+        return { std::move(scalar), std::move(simd) };
+    }
+
+    //==============================================================================
+    /** Third-octave band levels (dB) of one channel, from Hann-windowed, half-overlapped frames */
+    std::vector<double> getBandLevels(const float* samples, int numSamples)
+    {
+        constexpr int fftSize = 1 << fftOrder;
+        juce::dsp::FFT fft(fftOrder);
+        juce::dsp::WindowingFunction<float> window(static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann, false);
+
+        std::vector<double> power(static_cast<size_t>(fftSize / 2 + 1), 0.0);
+        std::vector<float> frame(static_cast<size_t>(fftSize * 2));
+
+        for (int start = 0; start + fftSize <= numSamples; start += fftSize / 2)
+        {
+            std::fill(frame.begin(), frame.end(), 0.0f);
+            std::copy(samples + start, samples + start + fftSize, frame.begin());
+            window.multiplyWithWindowingTable(frame.data(), static_cast<size_t>(fftSize));
+            fft.performFrequencyOnlyForwardTransform(frame.data());
+
+            for (size_t bin = 0; bin < power.size(); ++bin)
+                power[bin] += static_cast<double>(frame[bin]) * static_cast<double>(frame[bin]);
+        }
+
+        std::vector<double> levels;
+        const double binWidth = sampleRate / fftSize;
+
+        for (double centre = 25.0; centre * std::pow(2.0, 1.0 / 6.0) < sampleRate * 0.5; centre *= std::pow(2.0, 1.0 / 3.0))
+        {
+            const auto firstBin = static_cast<size_t>(std::ceil(centre * std::pow(2.0, -1.0 / 6.0) / binWidth));
+            const auto endBin = static_cast<size_t>(std::ceil(centre * std::pow(2.0, 1.0 / 6.0) / binWidth));
+
+            // Bands narrower than one bin at the bottom of the range
+            if (firstBin >= endBin)
+                continue;
+
+            double bandPower = 0.0;
+            for (size_t bin = firstBin; bin < endBin; ++bin)
+                bandPower += power[bin];
+
+            levels.push_back(10.0 * std::log10(bandPower + 1.0e-30));
+        }
+
+        return levels;
+    }
+
+    struct Difference
+    {
+        double maxErrorDb = -200.0;
+        double rmsErrorDb = -200.0;
+        double spectralDb = 0.0;
+        bool identical = true;
+    };
+
+    Difference measure(const juce::AudioBuffer<float>& reference, const juce::AudioBuffer<float>& output)
+    {
+        Difference difference;
+        double maxError = 0.0;
+        double errorPower = 0.0;
+        double referencePower = 0.0;
+
+        for (int channel = 0; channel < reference.getNumChannels(); ++channel)
+        {
+            const auto* expected = reference.getReadPointer(channel);
+            const auto* actual = output.getReadPointer(channel);
+
+            for (int i = 0; i < reference.getNumSamples(); ++i)
+            {
+                const double error = static_cast<double>(actual[i]) - static_cast<double>(expected[i]);
+                maxError = juce::jmax(maxError, std::abs(error));
+                errorPower += error * error;
+                referencePower += static_cast<double>(expected[i]) * static_cast<double>(expected[i]);
+            }
+
+            const auto expectedBands = getBandLevels(expected, reference.getNumSamples());
+            const auto actualBands = getBandLevels(actual, reference.getNumSamples());
+            const double loudest = *std::max_element(expectedBands.begin(), expectedBands.end());
+
+            for (size_t band = 0; band < expectedBands.size(); ++band)
+                if (expectedBands[band] > loudest - spectralRangeDb)
+                    difference.spectralDb = juce::jmax(difference.spectralDb, std::abs(actualBands[band] - expectedBands[band]));
+        }
+
+        difference.identical = maxError == 0.0;
+
+        if (maxError > 0.0)
+            difference.maxErrorDb = juce::jmax(-200.0, 20.0 * std::log10(maxError));
+
+        // Relative to the reference, or to full scale if the reference is silent
+        if (errorPower > 0.0)
+            difference.rmsErrorDb = juce::jmax(-200.0, 10.0 * std::log10(errorPower / (referencePower > 0.0 ? referencePower : 1.0)));
+
+        return difference;
+    }
+
+    /** Print one line of the report; returns true if the case is within tolerance */
+    bool report(const juce::String& name, const Difference& difference, const Tolerance& tolerance)
+    {
+        juce::StringArray failures;
+
+        if (difference.maxErrorDb > tolerance.maxErrorDb)
+            failures.add("max error above " + juce::String(tolerance.maxErrorDb, 1) + " dBFS");
+
+        if (difference.rmsErrorDb > tolerance.rmsErrorDb)
+            failures.add("RMS error above " + juce::String(tolerance.rmsErrorDb, 1) + " dB");
+
+        if (difference.spectralDb > tolerance.spectralDb)
+            failures.add("spectrum off by more than " + juce::String(tolerance.spectralDb, 2) + " dB");
+
+        std::cout << name.paddedRight(' ', 26)
+                  << "max " << juce::String(difference.maxErrorDb, 1).paddedLeft(' ', 6) << " dBFS   "
+                  << "rms " << juce::String(difference.rmsErrorDb, 1).paddedLeft(' ', 6) << " dB   "
+                  << "spectral " << juce::String(difference.spectralDb, 3) << " dB   "
+                  << (failures.isEmpty() ? (difference.identical ? "ok (bit-identical)" : "ok")
+                                         : "FAIL: " + failures.joinIntoString(", "))
+                  << std::endl;
+
+        return failures.isEmpty();
+    }
+
+    /** One report line per build of the compander gain computer; returns how many exceed Compander::maxGainError */
+    int checkCompanderGain()
+    {
+        auto check = [](const char* name, float error)
+        {
+            const bool passed = error <= Compander<float>::maxGainError;
+            std::cout << juce::String(name).paddedRight(' ', 26)
+                      << "relative error " << juce::String(error, 9) << "   "
+                      << (passed ? "ok" : "FAIL: above " + juce::String(Compander<float>::maxGainError, 9))
+                      << std::endl;
+            return passed;
+        };
+
+        const Compander<float> scalar;
+        const Compander<LaneOps::FloatVector> simd;
+
+        int numFailed = 0;
+        numFailed += check("compander-gain-float", scalar.getGainComputerError()) ? 0 : 1;
+        numFailed += check("compander-gain-simd", simd.getGainComputerError()) ? 0 : 1;
+        return numFailed;
+    }
+
+    //==============================================================================
+    bool writeWav(const juce::File& file, const juce::AudioBuffer<float>& buffer)
+    {
+        file.deleteFile();
+
+        std::unique_ptr<juce::FileOutputStream> stream(file.createOutputStream());
+        if (stream == nullptr || ! stream->openedOk())
+            return false;
+
+        // 32 bits: JUCE writes IEEE float, so references keep every bit of the render
+        juce::WavAudioFormat wavFormat;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wavFormat.createWriterFor(
+            stream.get(), sampleRate, static_cast<unsigned int>(buffer.getNumChannels()), 32, {}, 0));
+
+        if (writer == nullptr)
+            return false;
+
+        stream.release(); // the writer owns it now
+        return writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+    }
+
+    /** Read a reference; returns an error message, or an empty string on success */
+    juce::String readReference(juce::AudioFormatManager& formats, const juce::File& file,
+                               const juce::AudioBuffer<float>& expectedShape, juce::AudioBuffer<float>& reference)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+        if (reader == nullptr)
+            return "can't read reference " + file.getFullPathName();
+
+        if (reader->sampleRate != sampleRate
+            || static_cast<int>(reader->numChannels) != expectedShape.getNumChannels()
+            || reader->lengthInSamples != expectedShape.getNumSamples())
+            return "reference has a different rate, channel count or length (re-record it)";
+
+        reference.setSize(expectedShape.getNumChannels(), expectedShape.getNumSamples());
+        reader->read(&reference, 0, reference.getNumSamples(), 0, true, true);
+        return {};
+    }
+
+    void printUsage()
+    {
+        std::cout
+            << "Usage: DM2DelayNullTest [options]\n"
+            << "\n"
+            << "Options:\n"
+            << "  --references=<dir>   Reference renders (default: Tools/NullTest/References in the source tree)\n"
+            << "  --record             Write the current renders as the new references\n"
+            << "  --variant=<name>     Compare an alternative implementation instead of the references:\n"
+            << "                       simd (SIMD vs scalar stage graph), compact (16-bit vs float delay storage)\n"
+            << "  --baseline           Diagnostic: null the ring buffer chains against the plain per-sample\n"
+            << "                       chain in BaselineChain.h instead of the references\n"
+            << "  --only=<list>        Cases to run, e.g. standard-impulse,custom-plucks,compander-gain\n"
+            << "  --dump=<dir>         Write each render and its difference from the reference as WAV\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    // APVTS needs a message manager; the main thread plays that role but never dispatches
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const juce::File referenceFolder = args.containsOption("--references")
+        ? juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--references"))
+        : juce::File(DM2DELAY_NULLTEST_REFERENCES);
+
+    const bool record = args.containsOption("--record");
+
+    const bool againstBaseline = args.containsOption("--baseline");
+
+    const Variant* variant = nullptr;
+    if (args.containsOption("--variant"))
+    {
+        const auto name = args.getValueForOption("--variant");
+        for (auto& candidate : variants)
+            if (name == candidate.name)
+                variant = &candidate;
+
+        if (variant == nullptr)
+        {
+            std::cerr << "Unknown variant '" << name << "'" << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+
+    juce::StringArray only;
+    if (args.containsOption("--only"))
+        only = juce::StringArray::fromTokens(args.getValueForOption("--only"), ",", {});
+
+    juce::File dumpFolder;
+    if (args.containsOption("--dump"))
+    {
+        dumpFolder = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--dump"));
+        dumpFolder.createDirectory();
+    }
+
+    if (record && ! referenceFolder.createDirectory())
+    {
+        std::cerr << "Can't create " << referenceFolder.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    if (variant != nullptr)
+        std::cout << "Variant: " << variant->description << std::endl;
+    else if (record)
+        std::cout << "Recording references in " << referenceFolder.getFullPathName() << std::endl;
+    else if (againstBaseline)
+        std::cout << "Comparing against the baseline chain (ring buffer chains only)" << std::endl;
+    else
+        std::cout << "Comparing against references in " << referenceFolder.getFullPathName() << std::endl;
+
+    int numFailed = 0;
+    int numMissing = 0;
+    int numRun = 0;
+
+    if (! record && (only.isEmpty() || only.contains("compander-gain")))
+    {
+        numRun += 2;
+        numFailed += checkCompanderGain();
+    }
+
+    for (auto& testCase : testCases)
+    {
+        if (! only.isEmpty() && ! only.contains(testCase.name))
+            continue;
+
+        if (againstBaseline && variant == nullptr && ! record && ! hasBaseline(testCase.chain))
+            continue;
+
+        ++numRun;
+        const auto input = makeSignal(testCase.signal);
+
+        juce::AudioBuffer<float> reference;
+        juce::AudioBuffer<float> output;
+        Tolerance tolerance = testCase.tolerance;
+
+        if (variant != nullptr)
+        {
+            tolerance = variant->tolerance;
+
+            if (juce::String(variant->name) == "simd")
+            {
+                auto renders = renderLanes(testCase.chain, input);
+                reference = std::move(renders.first);
+                output = std::move(renders.second);
+            }
+            else
+            {
+                reference = renderProcessor(testCase.chain, input, false);
+                output = renderProcessor(testCase.chain, input, true);
+            }
+        }
+        else if (againstBaseline && ! record)
+        {
+            tolerance = baselineTolerance;
+            reference = renderBaseline(testCase.chain, input);
+            output = renderProcessor(testCase.chain, input, false);
+        }
+        else
+        {
+            output = renderProcessor(testCase.chain, input, false);
+            const auto file = referenceFolder.getChildFile(juce::String(testCase.name) + ".wav");
+
+            if (record)
+            {
+                const bool written = writeWav(file, output);
+                std::cout << juce::String(testCase.name).paddedRight(' ', 26)
+                          << (written ? "recorded" : "FAIL: can't write " + file.getFullPathName()) << std::endl;
+                numFailed += written ? 0 : 1;
+                continue;
+            }
+
+            // Not a difference in the sound, but nothing has been checked either: fail the run
+            if (! file.existsAsFile())
+            {
+                std::cout << juce::String(testCase.name).paddedRight(' ', 26)
+                          << "MISSING: no reference " << file.getFullPathName() << " (record one with --record)" << std::endl;
+                ++numMissing;
+                continue;
+            }
+
+            const auto error = readReference(formats, file, output, reference);
+            if (error.isNotEmpty())
+            {
+                std::cout << juce::String(testCase.name).paddedRight(' ', 26) << "FAIL: " << error << std::endl;
+                ++numFailed;
+                continue;
+            }
+        }
+
+        if (dumpFolder != juce::File())
+        {
+            juce::AudioBuffer<float> difference(output);
+            for (int channel = 0; channel < difference.getNumChannels(); ++channel)
+                difference.addFrom(channel, 0, reference, channel, 0, reference.getNumSamples(), -1.0f);
+
+            writeWav(dumpFolder.getChildFile(juce::String(testCase.name) + ".wav"), output);
+            writeWav(dumpFolder.getChildFile(juce::String(testCase.name) + "-difference.wav"), difference);
+        }
+
+        if (! report(testCase.name, measure(reference, output), tolerance))
+            ++numFailed;
+    }
+
+    std::cout << numRun << " cases, " << numFailed << " failed";
+    if (numMissing > 0)
+        std::cout << ", " << numMissing << " without a reference";
+    std::cout << std::endl;
+    return numFailed == 0 && numMissing == 0 ? 0 : 1;
+}
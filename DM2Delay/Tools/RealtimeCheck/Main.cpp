@@ -0,0 +1,341 @@
+#include <juce_audio_utils/juce_audio_utils.h>
+#include "PluginProcessor.h"
+#include <iostream>
+
+/**
+ * DM2DelayRealtimeCheck - Drives the processor with the real-time guard on
+ * Built with DM2DELAY_REALTIME_GUARD=1, so any allocation, free or mutex lock
+ * inside processBlock aborts with a stack trace (see RealtimeGuard.h). The
+ * host side of each phase (parameter changes, state restores, re-preparing)
+ * runs between blocks, unguarded, exactly as a host would do it. A 7.1.4
+ * instance with the helper thread enabled covers the handoff, whose job runs
+ * under the same guard on the helper.
+ *
+ * Exit code 0 means every block rendered without a violation.
+ */
+namespace
+{
+    struct Options
+    {
+        double sampleRate = 48000.0;
+        int blockSize = 512;
+        int blocksPerPhase = 200;
+    };
+
+    void printUsage()
+    {
+        std::cout
+            << "Usage: DM2DelayRealtimeCheck [options]\n"
+            << "\n"
+            << "Options:\n"
+            << "  --rate=<hz>          Sample rate (default: 48000)\n"
+            << "  --block=<n>          Maximum block size in samples (default: 512)\n"
+            << "  --blocks=<n>         Blocks rendered per phase (default: 200)\n"
+            << "  --self-test          Allocate inside the guard on purpose; must abort\n";
+    }
+
+    void setParameter(DM2DelayAudioProcessor& processor, const juce::String& parameterID, float value)
+    {
+        if (auto* parameter = processor.getAPVTS().getParameter(parameterID))
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    void resetParameters(DM2DelayAudioProcessor& processor)
+    {
+        for (auto* parameter : processor.getParameters())
+            parameter->setValueNotifyingHost(parameter->getDefaultValue());
+    }
+
+    class Driver
+    {
+    public:
+        Driver(DM2DelayAudioProcessor& processorToDrive, const Options& optionsToUse)
+            : processor(processorToDrive)
+            , options(optionsToUse)
+            , buffer(processorToDrive.getTotalNumInputChannels(), optionsToUse.blockSize)
+            , random(1234)
+        {
+        }
+
+        /**
+         * Render one phase. hostAction(blockIndex) runs before each block, outside the guard
+         * @param randomBlockSizes Vary the block size from 1 sample up to the prepared maximum
+         */
+        template <typename HostAction>
+        void runPhase(const char* name, bool randomBlockSizes, HostAction&& hostAction)
+        {
+            std::cout << "  " << name << "..." << std::flush;
+
+            for (int block = 0; block < options.blocksPerPhase; ++block)
+            {
+                hostAction(block);
+
+                const int numSamples = randomBlockSizes ? 1 + random.nextInt(options.blockSize) : options.blockSize;
+                for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                    for (int i = 0; i < numSamples; ++i)
+                        buffer.setSample(channel, i, inputLevel * (random.nextFloat() * 2.0f - 1.0f));
+
+                juce::AudioBuffer<float> view(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), numSamples);
+                if (hostBypass)
+                    processor.processBlockBypassed(view, midi);
+                else
+                    processor.processBlock(view, midi);
+                ++blocksRendered;
+            }
+
+            std::cout << " ok" << std::endl;
+        }
+
+        /** Render through processBlockBypassed, as a host bypassing the plugin itself would */
+        void setHostBypass(bool shouldBypass) { hostBypass = shouldBypass; }
+
+        /** Peak level of the noise fed in (0 for silence) */
+        void setInputLevel(float newLevel) { inputLevel = newLevel; }
+
+        juce::Random& getRandom() { return random; }
+        int getBlocksRendered() const { return blocksRendered; }
+
+    private:
+        DM2DelayAudioProcessor& processor;
+        Options options;
+        juce::AudioBuffer<float> buffer;
+        juce::MidiBuffer midi;
+        juce::Random random;
+        float inputLevel = 0.5f;
+        bool hostBypass = false;
+        int blocksRendered = 0;
+    };
+
+    void prepare(DM2DelayAudioProcessor& processor, double sampleRate, int blockSize)
+    {
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    if (! RealtimeGuard::isEnabled())
+        std::cerr << "Warning: built without DM2DELAY_REALTIME_GUARD, violations will not be caught" << std::endl;
+
+    if (args.containsOption("--self-test"))
+    {
+        std::cout << "Allocating inside the guard; expect a violation report and abort" << std::endl;
+        RealtimeGuard::ScopedAudioThread guard;
+        auto* leaked = new std::vector<float>(256);
+        std::cerr << "Guard did not fire (" << leaked->size() << ")" << std::endl;
+        return 1;
+    }
+
+    // APVTS needs a message manager; the main thread plays that role but never dispatches
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    Options options;
+
+    if (args.containsOption("--rate"))
+        options.sampleRate = juce::jmax(8000.0, args.getValueForOption("--rate").getDoubleValue());
+
+    if (args.containsOption("--block"))
+        options.blockSize = juce::jmax(1, args.getValueForOption("--block").getIntValue());
+
+    if (args.containsOption("--blocks"))
+        options.blocksPerPhase = juce::jmax(1, args.getValueForOption("--blocks").getIntValue());
+
+    DM2DelayAudioProcessor processor;
+    processor.setNoiseSeed(1);
+    prepare(processor, options.sampleRate, options.blockSize);
+
+    Driver driver(processor, options);
+    auto& random = driver.getRandom();
+    auto& parameters = processor.getParameters();
+
+    std::cout << "Driving processBlock at " << options.sampleRate << " Hz, blocks up to "
+              << options.blockSize << " samples" << std::endl;
+
+    driver.runPhase("steady state", false, [](int) {});
+
+    driver.runPhase("mode switches", false, [&](int block)
+    {
+        setParameter(processor, Parameters::modeID, (block / 3) % 2 == 0 ? 1.0f : 0.0f);
+    });
+
+    driver.runPhase("engine switches", false, [&](int block)
+    {
+        setParameter(processor, Parameters::modeID, 1.0f);
+        setParameter(processor, Parameters::engineID, (block / 5) % 2 == 0 ? 1.0f : 0.0f);
+    });
+
+    driver.runPhase("routing switches", false, [&](int block)
+    {
+        setParameter(processor, Parameters::modeID, (block / 6) % 2 == 0 ? 1.0f : 0.0f);
+        setParameter(processor, Parameters::routingID, (block / 4) % 2 == 0 ? 1.0f : 0.0f);
+    });
+
+    driver.runPhase("oversampling changes", true, [&](int block)
+    {
+        setParameter(processor, Parameters::oversamplingID, static_cast<float>((block / 4) % 4));
+    });
+
+    resetParameters(processor);
+
+    for (auto* parameter : parameters)
+    {
+        const auto name = "sweep " + parameter->getName(64);
+        driver.runPhase(name.toRawUTF8(), false, [&](int block)
+        {
+            // Up and back down across the phase
+            const float position = static_cast<float>(block) / static_cast<float>(options.blocksPerPhase - 1 > 0 ? options.blocksPerPhase - 1 : 1);
+            parameter->setValueNotifyingHost(position < 0.5f ? position * 2.0f : 2.0f - position * 2.0f);
+        });
+
+        parameter->setValueNotifyingHost(parameter->getDefaultValue());
+    }
+
+    driver.runPhase("random automation, random block sizes", true, [&](int)
+    {
+        auto* parameter = parameters[random.nextInt(parameters.size())];
+        parameter->setValueNotifyingHost(random.nextFloat());
+    });
+
+    driver.runPhase("bypass toggles", true, [&](int block)
+    {
+        processor.setBypass(block % 7 < 3);
+        setParameter(processor, Parameters::trailsID, (block / 14) % 2 == 0 ? 1.0f : 0.0f);
+    });
+
+    processor.setBypass(false);
+
+    driver.runPhase("host bypass", true, [&](int block)
+    {
+        driver.setHostBypass(block % 9 < 4);
+    });
+
+    driver.setHostBypass(false);
+
+    // Short tail, so the plugin goes idle within a burst of silence and wakes on the next noise
+    setParameter(processor, Parameters::delayTimeID, Parameters::delayTimeMin);
+    setParameter(processor, Parameters::feedbackID, 0.0f);
+
+    driver.runPhase("idle and wake", true, [&](int block)
+    {
+        driver.setInputLevel(block % 100 == 0 ? 0.5f : 0.0f);
+        processor.setIdleNoiseFloor(block % 200 >= 100);
+    });
+
+    driver.setInputLevel(0.5f);
+    processor.setIdleNoiseFloor(false);
+    resetParameters(processor);
+
+    // Snapshots taken host-side in both state formats, restored between blocks like a host recalling presets
+    juce::Array<juce::MemoryBlock> snapshots;
+    for (int i = 0; i < 8; ++i)
+    {
+        for (auto* parameter : parameters)
+            parameter->setValueNotifyingHost(random.nextFloat());
+
+        processor.setStateFormat(i % 2 == 0 ? DM2DelayAudioProcessor::StateFormat::binary
+                                            : DM2DelayAudioProcessor::StateFormat::xml);
+
+        juce::MemoryBlock state;
+        processor.getStateInformation(state);
+        snapshots.add(state);
+    }
+
+    processor.setStateFormat(DM2DelayAudioProcessor::StateFormat::xml);
+
+    driver.runPhase("state restores", true, [&](int block)
+    {
+        if (block % 2 == 0)
+        {
+            const auto& state = snapshots.getReference(random.nextInt(snapshots.size()));
+            processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+        }
+    });
+
+    // Program changes are stored by the audio thread at the start of the next block
+    driver.runPhase("preset changes", true, [&](int block)
+    {
+        if (block % 3 == 0)
+            processor.setCurrentProgram(random.nextInt(processor.getNumPrograms()));
+    });
+
+    // The profiler overlay: timing toggled mid-run, statistics reset and drained by the message thread,
+    // so the publishing, the load measurer and the section cycle counts all run under the guard
+    auto& profiler = processor.getProfiler();
+
+    driver.runPhase("profiling", true, [&](int block)
+    {
+        profiler.setEnabled(block % 50 < 35);
+
+        if (block % 20 == 10)
+            profiler.reset();
+
+        if (block % 5 == 0)
+            profiler.collect();
+    });
+
+    profiler.setEnabled(false);
+
+    // Hosts re-prepare with new settings while the instance lives on
+    processor.releaseResources();
+    prepare(processor, options.sampleRate * 2.0, juce::jmax(1, options.blockSize / 2));
+
+    Options halfBlocks = options;
+    halfBlocks.blockSize = juce::jmax(1, options.blockSize / 2);
+    Driver secondDriver(processor, halfBlocks);
+    secondDriver.runPhase("re-prepared at twice the rate", true, [&](int)
+    {
+        auto* parameter = parameters[random.nextInt(parameters.size())];
+        parameter->setValueNotifyingHost(random.nextFloat());
+    });
+
+    // 7.1.4 needs more than one channel group at any SIMD width. With the helper enabled, chunks of
+    // helperMinChunkSize or more are split across it and the audio thread; smaller ones render serially
+    DM2DelayAudioProcessor surroundProcessor;
+    juce::AudioProcessor::BusesLayout surround;
+    surround.inputBuses.add(juce::AudioChannelSet::create7point1point4());
+    surround.outputBuses.add(juce::AudioChannelSet::create7point1point4());
+
+    if (! surroundProcessor.setBusesLayout(surround))
+    {
+        std::cerr << "7.1.4 layout rejected" << std::endl;
+        return 1;
+    }
+
+    surroundProcessor.setNoiseSeed(1);
+    surroundProcessor.setHelperThreadEnabled(true);
+
+    Options helperBlocks = options;
+    helperBlocks.blockSize = juce::jmax(options.blockSize, 2 * DM2DelayAudioProcessor::helperMinChunkSize);
+    prepare(surroundProcessor, options.sampleRate, helperBlocks.blockSize);
+
+    Driver helperDriver(surroundProcessor, helperBlocks);
+    auto& surroundParameters = surroundProcessor.getParameters();
+
+    helperDriver.runPhase("7.1.4, helper thread", false, [&](int block)
+    {
+        // Now and then leave the helper long enough to stop spinning and sleep, so the post wakes it
+        if (block % 4 == 0)
+            juce::Thread::sleep(5);
+    });
+
+    helperDriver.runPhase("7.1.4, helper thread, random automation and block sizes", true, [&](int)
+    {
+        auto* parameter = surroundParameters[helperDriver.getRandom().nextInt(surroundParameters.size())];
+        parameter->setValueNotifyingHost(helperDriver.getRandom().nextFloat());
+    });
+
+    surroundProcessor.releaseResources();
+
+    const int totalBlocks = driver.getBlocksRendered() + secondDriver.getBlocksRendered() + helperDriver.getBlocksRendered();
+    std::cout << totalBlocks << " blocks rendered, no real-time violations" << std::endl;
+    return 0;
+}